@@ -1,6 +1,5 @@
 #include "src/pch.h"
 #include "ClientConnectionHandler.h"
-#include "tcp-ip/ISerializable.h"
 #include "threading/Thread.h"
 
 void ClientConnectionHandler::Init(Shared<StateMachine>* stateMachine)
@@ -31,11 +30,6 @@ void ClientConnectionHandler::TryToConnectToServer(const std::string* adress)
     StartThread(adress);
 }
 
-void ClientConnectionHandler::SendDataToServer(ISerializable& data)
-{
-    SendDataToServer(data.Serialize().dump());
-}
-
 void ClientConnectionHandler::StartThread(const std::string* ipAdress)
 {
     m_SharedIsRunning.WaitGet().Get() = true;
@@ -65,30 +59,38 @@ void ClientConnectionHandler::RunClient(const std::string* adress)
         m_IsClientRunning = false;
     }
 
-    std::stringstream ss;
+    std::vector<TcpIp::Frame> messages;
     while (m_IsClientRunning)
     {
         try
         {
-            while (m_Client->FetchPendingData(ss))
+            while (m_Client->FetchPendingData(messages))
             {
-                Json j;
-                try
-                {
-                    j = Json::parse(ss.str());
-                }
-                catch (const std::exception& e)
-                {
-                    DebugLog("Failed to parse JSON from server: " + std::string(e.what()) + "\n");
-                    return;
-                }
-                if (!j.contains("Type"))
+                for (const TcpIp::Frame& frame : messages)
                 {
-                    DebugLog("Json does not contain a Type!\n");
-                    return;
+                    // Routed on the frame header: what this client can't read is skipped without parsing it
+                    if (frame.Info.Type == 0 || frame.Info.Type > static_cast<uint8_t>(MsgType::GameOver) || frame.Info.HasFlag(TcpIp::FRAME_COMPRESSED))
+                    {
+                        DebugLog("Skipped a message of unknown type " + std::to_string(frame.Info.Type) + " from server\n");
+                        continue;
+                    }
+
+                    try
+                    {
+                        const ReceivedMessage message(frame.Data);
+                        m_StateMachine->WaitGet()->OnReceiveData(message);
+                    }
+                    catch (const TcpIp::TcpIpException&)
+                    {
+                        throw;
+                    }
+                    catch (const std::exception& e)
+                    {
+                        DebugLog("Failed to read a message from server: " + std::string(e.what()) + "\n");
+                        return;
+                    }
                 }
-                m_StateMachine->WaitGet()->OnReceiveData(j);
-                ss.str(std::string());
+                messages.clear();
             }
         }
         catch (const TcpIp::TcpIpException& e)
@@ -116,7 +118,7 @@ void ClientConnectionHandler::RunClient(const std::string* adress)
     RELEASE(m_Client);
 }
 
-void ClientConnectionHandler::SendDataToServer(const std::string& data)
+void ClientConnectionHandler::SendDataToServer(const std::string& data, TcpIp::FrameInfo info)
 {
     if (data.empty())
     {
@@ -130,7 +132,7 @@ void ClientConnectionHandler::SendDataToServer(const std::string& data)
         return;
     }
 
-    m_Client->Send(data);
+    m_Client->Send(data, info);
 }
 
 bool ClientConnectionHandler::IsConnected()
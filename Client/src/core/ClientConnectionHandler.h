@@ -1,8 +1,8 @@
 #pragma once
 #include "src/tcp-ip/TcpIpClient.h"
 #include "src/core/StateMachine/StateMachine.h"
+#include "tcp-ip/MessageCodec.h"
 
-struct ISerializable;
 class Thread;
 
 enum ConnectionStateInfo
@@ -33,8 +33,15 @@ public:
 
     void Disconnect();
     void TryToConnectToServer(const std::string* adress);
-    void SendDataToServer(ISerializable& data);
-    void SendDataToServer(const std::string& data);
+    template <MsgType T>
+    void SendDataToServer(const Message<T>& message) { SendDataToServer(EncodeMessage(message, m_Encoding), GetFrameInfo<T>(m_Encoding)); }
+    void SendDataToServer(const std::string& data, TcpIp::FrameInfo info);
+
+    /// <summary>
+    /// The encoding of the messages sent to the server, and asked for the messages it sends back. (See Login)
+    /// </summary>
+    MessageEncoding GetEncoding() const { return m_Encoding; }
+    void SetEncoding(MessageEncoding encoding) { m_Encoding = encoding; }
 
     Shared<ConnectionStateInfo>& GetConnectionInfo() { return m_IsClientConnected; }
     bool IsConnected();
@@ -56,4 +63,7 @@ private:
 
     bool m_IsClientRunning = false;
     Shared<bool> m_SharedIsRunning = false;
+
+    // Binary is smaller and faster to read, switch to JSON to read the messages while debugging
+    MessageEncoding m_Encoding = MessageEncoding::Binary;
 };
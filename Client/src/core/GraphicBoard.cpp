@@ -50,7 +50,7 @@ void GraphicBoard::DrawBoard()
 
 void GraphicBoard::InstanciateNewPlayerShape(const TicTacToe::Piece piece, unsigned int cell)
 {
-    m_Board[cell] = piece;
+    SetPiece(cell, piece);
 
     auto pos = sf::Vector2f(GetGraphicPiece(cell).GetPosition());
 
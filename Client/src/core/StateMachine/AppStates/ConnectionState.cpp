@@ -138,6 +138,7 @@ void ConnectionState::OnUpdate(float dt)
 
             Message<MsgType::Login> message;
             message.Username = m_Name;
+            message.Encoding = ClientConnectionHandler::GetInstance().GetEncoding();
             ClientConnectionHandler::GetInstance().SendDataToServer(message);
 
             timeOutTimer = 0.0f;
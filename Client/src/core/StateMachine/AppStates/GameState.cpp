@@ -166,16 +166,16 @@ void GameState::OnExit()
     m_Window->ClearAllDrawables();
 }
 
-void GameState::OnReceiveData(const Json& serializeData)
+void GameState::OnReceiveData(const ReceivedMessage& received)
 {
-    const auto type = Message<>::GetType(serializeData);
+    const auto type = received.GetType();
 
     using enum MsgType;
     switch (type)
     {
     case GameStarted:
     {
-        const Message<GameStarted> message(serializeData);
+        const Message<GameStarted> message = received.As<GameStarted>();
         const Piece startPiece = message.StartPlayer == message.PlayerX ? Piece::X : Piece::O;
 
         ClearBoard();
@@ -207,7 +207,7 @@ void GameState::OnReceiveData(const Json& serializeData)
     }
     case AcceptMakeMove:
     {
-        const Message<AcceptMakeMove> message(serializeData);
+        const Message<AcceptMakeMove> message = received.As<AcceptMakeMove>();
 
         m_Board.InstanciateNewPlayerShape(message.Piece, message.Cell);
         
@@ -225,7 +225,7 @@ void GameState::OnReceiveData(const Json& serializeData)
     }
     case GameOver:
     {
-        const Message<GameOver> message(serializeData);
+        const Message<GameOver> message = received.As<GameOver>();
 
         m_WaitingServerResponse = false;
 
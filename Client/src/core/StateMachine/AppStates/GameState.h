@@ -16,7 +16,7 @@ public:
     void OnEnter() override;
     void OnUpdate(float dt) override;
     void OnExit() override;
-    void OnReceiveData(const Json& serializeData) override;
+    void OnReceiveData(const ReceivedMessage& message) override;
 
 
     GameState(StateMachine* stateMachine, Window* m_Window);
@@ -117,7 +117,7 @@ void HistoryState::OnEnter()
     m_Window->RegisterDrawable(m_GameWinnerText);
 
     Message<MsgType::FetchGameHistoryList> message;
-    ClientConnectionHandler::GetInstance().SendDataToServer(message.Serialize().dump());
+    ClientConnectionHandler::GetInstance().SendDataToServer(message);
 }
 
 void HistoryState::OnUpdate(float dt)
@@ -137,20 +137,20 @@ void HistoryState::OnExit()
     m_Window->ClearAllDrawables();
 }
 
-void HistoryState::OnReceiveData(const Json& serializeData)
+void HistoryState::OnReceiveData(const ReceivedMessage& message)
 {
     m_CurrentGameIndex = 0;
     m_CurrentMoveIndex = 0;
     m_Games.clear();
 
-    const auto type = Message<>::GetType(serializeData);
+    const auto type = message.GetType();
 
     using enum MsgType;
     switch (type)
     {
     case GameHistoryList:
     {
-        const Message<GameHistoryList> historyList(serializeData);
+        const Message<GameHistoryList> historyList = message.As<GameHistoryList>();
 
         for (const auto& game : historyList.GameHistory)
         {
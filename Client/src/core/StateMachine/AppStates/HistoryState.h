@@ -20,7 +20,7 @@ public:
 
 private:
 
-    void OnReceiveData(const Json& serializeData) override;
+    void OnReceiveData(const ReceivedMessage& message) override;
     void DisplaySelectedGame();
 
     void NextGame();
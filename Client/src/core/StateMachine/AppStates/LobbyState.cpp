@@ -20,10 +20,12 @@ LobbyState::~LobbyState()
 void LobbyState::OnEnter()
 {
     m_IsTryingToJoinLobby = false;
-    m_IsLobbyInit = false;
+    // An answer that arrived in another state was ignored
+    m_IsFetchingLobbyList = false;
 
-    Message<MsgType::FetchLobbyList> message;
-    ClientConnectionHandler::GetInstance().SendDataToServer(message.Serialize().dump());
+    // Shows the lobbies we knew until the changes arrive
+    CreateLobbyButtons();
+    FetchLobbyList();
 
     m_HistoryButton = new ButtonComponent(sf::Vector2f(500, 450), sf::Vector2f(200, 100), sf::Color(4, 139, 15));
     m_HistoryButton->SetButtonText("History", sf::Color::White, 30, TextAlignment::Center);
@@ -66,71 +68,19 @@ void LobbyState::OnExit()
     NULLPTR(m_HistoryButton);
 }
 
-void LobbyState::OnReceiveData(const Json& serializeData)
+void LobbyState::OnReceiveData(const ReceivedMessage& message)
 {
-    auto type = Message<>::GetType(serializeData);
+    auto type = message.GetType();
 
     using enum MsgType;
     switch (type)
     {
     case LobbyList:
-    {
-        Message<LobbyList> lobbyList(serializeData);
-
-        int i = 0;
-        for (const auto& lobby : lobbyList.LobbiesData)
-        {
-            int id = lobby.ID;
-            float x = (lobby.GameMode == GameModeType::CLASSIC) ? 300.0f : 650.0f;
-            float y = (i % 3) * 110.0f + 100.0f;
-            sf::Color color = (lobby.GameMode == GameModeType::CLASSIC) ? sf::Color(1, 215, 88) : sf::Color(255, 0, 0);
-            std::string lobbyName = (lobby.GameMode == GameModeType::CLASSIC) ? "Normal " : "Fast ";
-
-            int playerCount = 0;
-            if (!lobby.PlayerX.empty()) playerCount++;
-            if (!lobby.PlayerO.empty()) playerCount++;
-
-            if (m_IsLobbyInit)
-            {
-                m_Lobbies[i].ID = id;
-                m_Lobbies[i].GameMode = lobby.GameMode;
-                m_Lobbies[i].PlayerO = lobby.PlayerO;
-                m_Lobbies[i].PlayerX = lobby.PlayerX;
-
-                m_LobbyButtons[i]->SetButtonText(
-                    lobbyName + std::to_string(id) + "\n" + std::to_string(playerCount) + "/" + "2"
-                    , sf::Color::White, 30
-                    , TextAlignment::Center);
-
-                m_LobbyButtons[i]->SetOnClickCallback([=]()
-                {
-                    JoinLobbyRequest(i);
-                });
-            }
-            else
-            {
-                m_Lobbies.emplace_back(id, lobby.GameMode, "", "");
-
-                auto* m_LobbyButton = new ButtonComponent(sf::Vector2f(x, y), sf::Vector2f(200, 100), color);
-                m_LobbyButton->SetButtonText(
-                    lobbyName + std::to_string(id) + "\n" + std::to_string(playerCount) + "/" + "2"
-                    , sf::Color::White, 30
-                    , TextAlignment::Center);
-                m_LobbyButton->SetOnClickCallback([=]()
-                {
-                    JoinLobbyRequest(i);
-                });
-
-                m_LobbyButtons.push_back(m_LobbyButton);
-                m_Window->RegisterDrawable(m_LobbyButton);
-            }
-
-            i++;
-        }
-        m_IsLobbyInit = true;
-
+        ReceiveLobbyList(message.As<LobbyList>());
+        break;
+    case RefreshLobbyList:
+        ReceiveLobbyChanges(message.As<RefreshLobbyList>());
         break;
-    }
     case AcceptJoinLobby:
     {
         ((GameState*)m_StateMachine->GetState("GameState"))->SetLobbyID(m_CurrentLobbyID);
@@ -159,5 +109,146 @@ void LobbyState::JoinLobbyRequest(int lobbyID)
     Message<MsgType::TryToJoinLobby> message;
     message.LobbyId = m_CurrentLobbyID;
     
-    ClientConnectionHandler::GetInstance().SendDataToServer(message.Serialize().dump());
+    ClientConnectionHandler::GetInstance().SendDataToServer(message);
+}
+
+void LobbyState::ReceiveLobbyList(const Message<MsgType::LobbyList>& message)
+{
+    m_IsFetchingLobbyList = false;
+    m_LobbyListVersion = message.Version;
+
+    // Usually the same lobbies as before, only their players changed
+    bool isSameLobbies = message.LobbiesData.size() == m_Lobbies.size() && m_LobbyButtons.size() == m_Lobbies.size();
+    for (size_t i = 0; isSameLobbies && i < m_Lobbies.size(); i++)
+    {
+        isSameLobbies = message.LobbiesData[i].ID == m_Lobbies[i].ID;
+    }
+
+    if (isSameLobbies)
+    {
+        for (size_t i = 0; i < m_Lobbies.size(); i++)
+        {
+            SetLobbyData(i, message.LobbiesData[i]);
+        }
+    }
+    else
+    {
+        m_Lobbies = message.LobbiesData;
+        CreateLobbyButtons();
+    }
+}
+
+void LobbyState::ReceiveLobbyChanges(const Message<MsgType::RefreshLobbyList>& message)
+{
+    if (message.Version == m_LobbyListVersion)
+    {
+        m_IsFetchingLobbyList = false;
+        return;
+    }
+    if (message.BaseVersion != m_LobbyListVersion)
+    {
+        // We missed a change, the server knows which ones from our version
+        DebugLog("Lobby list changes from version " + std::to_string(message.BaseVersion) + " but we have " + std::to_string(m_LobbyListVersion));
+        FetchLobbyList();
+        return;
+    }
+
+    m_IsFetchingLobbyList = false;
+    m_LobbyListVersion = message.Version;
+
+    bool isLayoutChanged = false;
+    using enum LobbyChange;
+    for (const LobbyDelta& delta : message.Changes)
+    {
+        const auto it = std::find_if(m_Lobbies.begin(), m_Lobbies.end(),
+            [&](const LobbyData& lobby) { return lobby.ID == delta.Data.ID; });
+
+        if (delta.Change == Closed)
+        {
+            if (it == m_Lobbies.end()) continue;
+            m_Lobbies.erase(it);
+            isLayoutChanged = true;
+        }
+        else if (it == m_Lobbies.end())
+        {
+            m_Lobbies.push_back(delta.Data);
+            isLayoutChanged = true;
+        }
+        else if (isLayoutChanged)
+            *it = delta.Data;
+        else
+            SetLobbyData(static_cast<size_t>(it - m_Lobbies.begin()), delta.Data);
+    }
+
+    if (isLayoutChanged)
+        CreateLobbyButtons();
+}
+
+void LobbyState::FetchLobbyList()
+{
+    if (m_IsFetchingLobbyList) return;
+
+    m_IsFetchingLobbyList = true;
+    Message<MsgType::FetchLobbyList> message;
+    message.KnownVersion = m_LobbyListVersion;
+    ClientConnectionHandler::GetInstance().SendDataToServer(message);
+}
+
+void LobbyState::SetLobbyData(size_t index, const LobbyData& data)
+{
+    LobbyData& lobby = m_Lobbies[index];
+    if (lobby.GameMode == data.GameMode && lobby.PlayerX == data.PlayerX && lobby.PlayerO == data.PlayerO)
+        return;
+
+    lobby = data;
+    UpdateLobbyButton(index);
+}
+
+void LobbyState::UpdateLobbyButton(size_t index)
+{
+    const LobbyData& lobby = m_Lobbies[index];
+    std::string lobbyName = (lobby.GameMode == GameModeType::CLASSIC) ? "Normal " : "Fast ";
+
+    int playerCount = 0;
+    if (!lobby.PlayerX.empty()) playerCount++;
+    if (!lobby.PlayerO.empty()) playerCount++;
+
+    m_LobbyButtons[index]->SetButtonText(
+        lobbyName + std::to_string(lobby.ID) + "\n" + std::to_string(playerCount) + "/" + "2"
+        , sf::Color::White, 30
+        , TextAlignment::Center);
+}
+
+void LobbyState::CreateLobbyButtons()
+{
+    DestroyLobbyButtons();
+
+    for (size_t i = 0; i < m_Lobbies.size(); i++)
+    {
+        const LobbyData& lobby = m_Lobbies[i];
+        float x = (lobby.GameMode == GameModeType::CLASSIC) ? 300.0f : 650.0f;
+        float y = (i % 3) * 110.0f + 100.0f;
+        sf::Color color = (lobby.GameMode == GameModeType::CLASSIC) ? sf::Color(1, 215, 88) : sf::Color(255, 0, 0);
+
+        auto* lobbyButton = new ButtonComponent(sf::Vector2f(x, y), sf::Vector2f(200, 100), color);
+        const int index = static_cast<int>(i);
+        lobbyButton->SetOnClickCallback([=]()
+        {
+            JoinLobbyRequest(index);
+        });
+
+        m_LobbyButtons.push_back(lobbyButton);
+        m_Window->RegisterDrawable(lobbyButton);
+        UpdateLobbyButton(i);
+    }
+}
+
+void LobbyState::DestroyLobbyButtons()
+{
+    for (auto* lobbyButton : m_LobbyButtons)
+    {
+        m_Window->UnregisterDrawable(lobbyButton);
+        delete lobbyButton;
+    }
+    m_LobbyButtons.clear();
 }
@@ -4,6 +4,7 @@
 #include "src/core/Components/ButtonComponent.h"
 #include "src/core/UIState/GameStateUI.h"
 #include "game/Lobby.h"
+#include "tcp-ip/ServerMessages.h"
 
 class LobbyState : public State
 {
@@ -11,7 +12,7 @@ public:
     void OnEnter() override;
     void OnUpdate(float dt) override;
     void OnExit() override;
-    void OnReceiveData(const Json& serializeData) override;
+    void OnReceiveData(const ReceivedMessage& message) override;
 
     LobbyState(StateMachine* stateMachine, Window* window);
     LobbyState(const LobbyState& other) = delete;
@@ -21,9 +22,25 @@ public:
     void JoinLobbyRequest(int lobbyID);
 
 private:
+    void ReceiveLobbyList(const Message<MsgType::LobbyList>& message);
+    void ReceiveLobbyChanges(const Message<MsgType::RefreshLobbyList>& message);
+    /// <summary>
+    /// Ask the server for the changes since the version we have.
+    /// </summary>
+    void FetchLobbyList();
+
+    /// <summary>
+    /// Replace the data of a lobby, updating its button only if something changed.
+    /// </summary>
+    void SetLobbyData(size_t index, const LobbyData& data);
+    void UpdateLobbyButton(size_t index);
+    /// <summary>
+    /// Create a button per lobby, replacing the existing ones. (Needed when lobbies are created or closed)
+    /// </summary>
+    void CreateLobbyButtons();
+    void DestroyLobbyButtons();
 
     int m_CurrentLobbyID;
-    bool m_IsLobbyInit = false;
     bool m_IsInLobby = false;
     bool m_IsTryingToJoinLobby = false;
 
@@ -35,6 +52,12 @@ private:
     ButtonComponent* m_HistoryButton = nullptr;
 
     std::string m_LobbyGameMode;
+    // One per lobby, in the same order
     std::vector<ButtonComponent*> m_LobbyButtons;
+    // Kept when leaving the state, the server then only sends the changes since m_LobbyListVersion
     std::vector<LobbyData> m_Lobbies;
+    // 0 until the first lobby list
+    unsigned int m_LobbyListVersion = 0;
+    // A fetch was sent and its answer has not arrived yet
+    bool m_IsFetchingLobbyList = false;
 };
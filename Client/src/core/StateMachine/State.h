@@ -1,6 +1,7 @@
 #pragma once 
 
 class StateMachine;
+class ReceivedMessage;
 
 class State
 {
@@ -12,7 +13,7 @@ public:
     virtual void OnEnter() = 0;
     virtual void OnUpdate(float dt) = 0;
     virtual void OnExit() = 0;
-    virtual void OnReceiveData(const Json& serializeData) {};
+    virtual void OnReceiveData(const ReceivedMessage& message) {};
 
 protected:
     StateMachine* m_StateMachine;
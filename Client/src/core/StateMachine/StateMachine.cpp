@@ -39,9 +39,9 @@ void StateMachine::Start() const
     m_CurrentState->OnEnter();
 }
 
-void StateMachine::OnReceiveData(const Json& data) const
+void StateMachine::OnReceiveData(const ReceivedMessage& message) const
 {
-    m_CurrentState->OnReceiveData(data);
+    m_CurrentState->OnReceiveData(message);
 }
 
 void StateMachine::Update(float dt)
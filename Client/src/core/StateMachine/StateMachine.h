@@ -17,7 +17,7 @@ public:
 
     void Update(float dt);
     void Start() const;
-    void OnReceiveData(const Json& serializeData) const;
+    void OnReceiveData(const ReceivedMessage& message) const;
     /// <summary>
     /// Switch the current state to the state with the name newState
     /// </summary>
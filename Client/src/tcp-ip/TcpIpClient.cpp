@@ -5,6 +5,7 @@ TcpIpClient::TcpIpClient()
     : m_WsaData(TcpIp::InitializeWinsock())
     , m_ConnectSocket(INVALID_SOCKET)
     , m_ReadEvent(WSA_INVALID_EVENT)
+    , m_Decoder()
 {
 }
 
@@ -50,6 +51,7 @@ void TcpIpClient::Connect(const char* ip, int port)
     }
 
     m_ReadEvent = TcpIp::CreateEventObject(m_ConnectSocket, FD_READ | FD_CLOSE);
+    m_Decoder.Clear();
 }
 
 void TcpIpClient::Disconnect()
@@ -73,32 +75,39 @@ bool TcpIpClient::IsConnected() const
     return m_ConnectSocket != INVALID_SOCKET;
 }
 
-void TcpIpClient::Send(const char* data, u_long size)
+void TcpIpClient::Send(const char* data, u_long size, TcpIp::FrameInfo info)
 {
-    TcpIp::Send(m_ConnectSocket, data, size);
+    TcpIp::Send(m_ConnectSocket, data, size, info);
 }
 
-bool TcpIpClient::FetchPendingData(std::stringstream& ss)
+bool TcpIpClient::FetchPendingData(std::vector<TcpIp::Frame>& messages)
 {
     WSANETWORKEVENTS networkEvents;
     int iResult = WSAEnumNetworkEvents(m_ConnectSocket, m_ReadEvent, &networkEvents);
     if (iResult == SOCKET_ERROR)
         throw TcpIp::TcpIpException::Create(EVENT_EnumFailed, TCP_IP_WSA_ERROR);
 
+    const size_t previousCount = messages.size();
+    bool isOpen = true;
     if (networkEvents.lNetworkEvents & FD_READ)
     {
         if (networkEvents.iErrorCode[FD_READ_BIT] != 0)
             throw TcpIp::TcpIpException::Create(EVENT_FdReadHadError, networkEvents.iErrorCode[FD_READ_BIT]);
 
-        TcpIp::Receive(m_ConnectSocket, ss, DEFAULT_BUFFER_SIZE);
-        return true;
+        isOpen = TcpIp::ReceiveFrames(m_ConnectSocket, m_Decoder, messages);
     }
     if (networkEvents.lNetworkEvents & FD_CLOSE)
     {
         if (networkEvents.iErrorCode[FD_CLOSE_BIT] != 0)
             throw TcpIp::TcpIpException::Create(EVENT_FdCloseHadError, networkEvents.iErrorCode[FD_CLOSE_BIT]);
 
-        Disconnect();
+        // The server may have sent data right before closing, read it first
+        if (isOpen)
+            TcpIp::ReceiveFrames(m_ConnectSocket, m_Decoder, messages);
+        isOpen = false;
     }
-    return false;
+
+    if (!isOpen)
+        Disconnect();
+    return messages.size() > previousCount;
 }
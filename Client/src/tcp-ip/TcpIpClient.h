@@ -1,5 +1,6 @@
 #pragma once
 #include <WinSock2.h>
+#include <tcp-ip/FrameDecoder.h>
 
 /// <summary>
 /// TCP/IP Client.
@@ -28,18 +29,20 @@ public:
     /// <summary>
     /// Sends data to the connected server.
     /// </summary>
-    void Send(const char* data, u_long size);
-    void Send(const std::string& data) { Send(data.c_str(), static_cast<u_long>(data.size())); }
+    void Send(const char* data, u_long size, TcpIp::FrameInfo info = {});
+    void Send(const std::string& data, TcpIp::FrameInfo info = {}) { Send(data.c_str(), static_cast<u_long>(data.size()), info); }
     /// <summary>
-    /// Fetches pending data from the server.
+    /// Fetches every complete frame sent by the server.
     /// </summary>
-    /// <param name="ss">The stringstream to write the data to.</param>
-    /// <returns>True if data was fetched, false otherwise.</returns>
-    bool FetchPendingData(std::stringstream& ss);
+    /// <param name="messages">The frames are appended to this vector.</param>
+    /// <returns>True if at least one frame was fetched, false otherwise.</returns>
+    bool FetchPendingData(std::vector<TcpIp::Frame>& messages);
 
 private:
 
     WSADATA& m_WsaData;
     SOCKET m_ConnectSocket;
     WSAEVENT m_ReadEvent;
+    // Keeps the bytes of incomplete messages between two reads
+    TcpIp::FrameDecoder m_Decoder;
 };
@@ -1,9 +1,25 @@
 #include "core/ServerApp.h"
+#include "bench/Benchmark.h"
 
-#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) && !defined(__CYGWIN__)
+// Command line arguments are plain ASCII, whatever the character type of the platform.
+template <typename Char>
+static std::string ToString(const Char* arg)
+{
+    std::string result;
+    while (*arg)
+        result += static_cast<char>(*arg++);
+    return result;
+}
 
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) && !defined(__CYGWIN__)
 // Entry point for a Windows program (Unicode)
-int wmain()
+int wmain(int argc, wchar_t* argv[])
+#elif defined(__linux__)
+// Entry point for a Linux program
+int main(int argc, char* argv[])
+#else
+#error Only Windows and Linux are supported
+#endif
 {
 
 #if defined(DEBUG) | defined(_DEBUG)
@@ -11,14 +27,28 @@ int wmain()
     _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
 
+    // `Server --bench <name>` runs a benchmark instead of the server
+    if (argc == 3 && ToString(argv[1]) == "--bench")
+        return Benchmark::Run(ToString(argv[2])) ? 0 : 1;
+
     ServerApp app;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = ToString(argv[i]);
+        // `Server --latency` prints the distribution of the message handling latency on shutdown
+        if (arg == "--latency")
+            app.EnableLatencyReport();
+        // `Server --lobby-refresh <ms>` sets how long lobby list changes are gathered before a broadcast
+        else if (arg == "--lobby-refresh" && i + 1 < argc)
+            app.SetLobbyRefreshWindow(std::chrono::milliseconds(std::atoi(ToString(argv[++i]).c_str())));
+        // `Server --bot <ms>` seats a bot against the players waiting alone, thinking up to <ms> per move
+        else if (arg == "--bot" && i + 1 < argc)
+            app.EnableBot(std::chrono::milliseconds(std::atoi(ToString(argv[++i]).c_str())));
+    }
+
     app.Init();
     app.Run();
     app.CleanUp();
 
     return 0;
 }
-
-#else
-#error Only Windows is supported
-#endif
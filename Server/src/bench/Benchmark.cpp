@@ -0,0 +1,121 @@
+#include "Benchmark.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Only in builds made for benchmarking: the server itself keeps the default allocator (and the debug CRT one)
+#ifdef BENCHMARK_COUNT_ALLOCATIONS
+
+// The global operator new is replaced below to count allocations
+#ifdef new
+#undef new
+#endif
+
+static std::atomic<size_t> s_AllocationCount = 0;
+
+void* operator new(size_t size)
+{
+    s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+#endif
+
+namespace Benchmark
+{
+    using enum TcpIp::ErrorCode;
+
+    bool Run(const std::string& name)
+    {
+        if (!IS_COUNTING_ALLOCATIONS)
+            std::cout << "Allocations are not counted (n/a), build with /p:CountAllocations=true to count them." << std::endl;
+
+        if (name == "send")
+            RunSend();
+        else if (name == "reactor")
+            RunReactor();
+        else if (name == "timers")
+            RunTimers();
+        else if (name == "codec")
+            RunCodec();
+        else if (name == "board")
+            RunBoard();
+        else
+        {
+            std::cout << "Unknown benchmark `" << name << "`. Available: send, reactor, timers, codec, board" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    size_t GetAllocationCount()
+    {
+#ifdef BENCHMARK_COUNT_ALLOCATIONS
+        return s_AllocationCount.load(std::memory_order_relaxed);
+#else
+        return 0;
+#endif
+    }
+
+    void CreateLoopbackPair(SOCKET& clientSide, SOCKET& serverSide)
+    {
+        TcpIp::InitializeWinsock();
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0; // Let the system choose a port
+
+        SOCKET listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (listenSocket == INVALID_SOCKET)
+            throw TcpIp::TcpIpException::Create(SOCKET_CreateFailed, TCP_IP_WSA_ERROR);
+
+        socklen_t addressLength = sizeof(address);
+        if (bind(listenSocket, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR
+            || getsockname(listenSocket, (sockaddr*)&address, &addressLength) == SOCKET_ERROR)
+            throw TcpIp::TcpIpException::Create(SOCKET_BindFailed, TCP_IP_WSA_ERROR);
+
+        if (listen(listenSocket, 1) == SOCKET_ERROR)
+            throw TcpIp::TcpIpException::Create(SOCKET_ListenFailed, TCP_IP_WSA_ERROR);
+
+        clientSide = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (clientSide == INVALID_SOCKET)
+            throw TcpIp::TcpIpException::Create(SOCKET_CreateFailed, TCP_IP_WSA_ERROR);
+
+        if (connect(clientSide, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR)
+            throw TcpIp::TcpIpException::Create(SOCKET_ConnectFailed, TCP_IP_WSA_ERROR);
+
+        serverSide = accept(listenSocket, nullptr, nullptr);
+        if (serverSide == INVALID_SOCKET)
+            throw TcpIp::TcpIpException::Create(SOCKET_AcceptFailed, TCP_IP_WSA_ERROR);
+
+        TcpIp::CloseSocket(listenSocket);
+    }
+}
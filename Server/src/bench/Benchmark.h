@@ -0,0 +1,93 @@
+#pragma once
+#include <chrono>
+#include <ostream>
+#include <string>
+
+/// <summary>
+/// Micro-benchmarks of the server hot paths.
+/// Run with `Server --bench <name>`, preferably with a Release build.
+/// Allocations are only counted when BENCHMARK_COUNT_ALLOCATIONS is defined, it replaces the global operator new:
+/// build with `msbuild Server.vcxproj /p:Configuration=Release /p:CountAllocations=true`.
+/// </summary>
+namespace Benchmark
+{
+#ifdef BENCHMARK_COUNT_ALLOCATIONS
+    constexpr bool IS_COUNTING_ALLOCATIONS = true;
+#else
+    constexpr bool IS_COUNTING_ALLOCATIONS = false;
+#endif
+
+    /// <summary>
+    /// Runs the benchmark with the given name.
+    /// </summary>
+    /// <returns>False if there is no benchmark with this name.</returns>
+    bool Run(const std::string& name);
+
+    /// <summary>
+    /// Returns the number of allocations made with operator new since the start of the program. (Always 0 unless they are counted)
+    /// </summary>
+    size_t GetAllocationCount();
+
+    /// <summary>
+    /// Creates two connected TCP sockets on the loopback interface. (Blocking mode)
+    /// </summary>
+    void CreateLoopbackPair(SOCKET& clientSide, SOCKET& serverSide);
+
+    /// <summary>
+    /// Allocations per item of a measure, printed as "n/a" when they are not counted.
+    /// </summary>
+    struct AllocationsPer
+    {
+        double Value;
+    };
+
+    inline std::ostream& operator<<(std::ostream& os, AllocationsPer allocations)
+    {
+        if (IS_COUNTING_ALLOCATIONS)
+            return os << allocations.Value;
+        return os << "n/a";
+    }
+
+    /// <summary>
+    /// Measures the time and allocations of a piece of code.
+    /// </summary>
+    struct Measure
+    {
+        Measure()
+            : Start(std::chrono::steady_clock::now())
+            , StartAllocations(GetAllocationCount())
+        {
+        }
+
+        double GetSeconds() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count(); }
+        size_t GetAllocations() const { return GetAllocationCount() - StartAllocations; }
+        AllocationsPer GetAllocationsPer(size_t items) const { return {static_cast<double>(GetAllocations()) / items}; }
+
+        std::chrono::steady_clock::time_point Start;
+        size_t StartAllocations;
+    };
+
+    // Benchmarks
+
+    /// <summary>
+    /// Throughput and allocations of the framed send path.
+    /// </summary>
+    void RunSend();
+    /// <summary>
+    /// Messages per second through TcpIpServer (receive, decode, parse, reply) with 1, 2 and 4 I/O threads.
+    /// </summary>
+    void RunReactor();
+    /// <summary>
+    /// Restarting and expiring the turn clocks of many FAST games, against scanning every deadline on each wake up.
+    /// </summary>
+    void RunTimers();
+    /// <summary>
+    /// Size, encode and decode time of the hot messages, in JSON and in binary.
+    /// </summary>
+    void RunCodec();
+    /// <summary>
+    /// Checking a move on a board sized at compile time, at run time, and through the Board wrapper.
+    /// Then scanning a whole Gomoku board with each SIMD kernel.
+    /// </summary>
+    void RunBoard();
+}
@@ -0,0 +1,150 @@
+#include "Benchmark.h"
+#include <game/FixedBoard.h>
+#include <iomanip>
+#include <random>
+
+namespace Benchmark
+{
+    constexpr size_t BOARD_GAMES = 200000;
+    constexpr size_t SCAN_POSITIONS = 1000;
+    constexpr size_t SCAN_REPEATS = 200;
+
+    // The cells played by each game, until a win or a full board
+    using GameMoves = std::vector<std::vector<unsigned int>>;
+
+    static GameMoves MakeGames(size_t width, size_t height, unsigned int alignementGoal)
+    {
+        std::mt19937 random(42);
+        TicTacToe::DynamicBoard board(width, height, alignementGoal);
+        GameMoves games(BOARD_GAMES);
+        for (auto& moves : games)
+        {
+            board.SetEmpty();
+            TicTacToe::Piece turn = TicTacToe::Piece::X;
+            for (size_t move = 0; move < width * height; ++move)
+            {
+                unsigned int cell;
+                do cell = random() % (width * height);
+                while (board.GetPiece(cell) != TicTacToe::Piece::Empty);
+
+                board.SetPiece(cell, turn);
+                moves.push_back(cell);
+                if (board.CheckWinAt(cell) != TicTacToe::Piece::Empty)
+                    break;
+                turn = turn == TicTacToe::Piece::X ? TicTacToe::Piece::O : TicTacToe::Piece::X;
+            }
+        }
+        return games;
+    }
+
+    // Replays the games like ServerApp::PlayMove: place the piece, check the move, then the draw
+    template <typename T>
+    static void RunBoard(const char* name, T& board, const GameMoves& games, bool checkWholeBoard)
+    {
+        size_t moves = 0, wins = 0;
+        Measure measure;
+        for (const auto& game : games)
+        {
+            board.SetEmpty();
+            TicTacToe::Piece turn = TicTacToe::Piece::X;
+            for (const unsigned int cell : game)
+            {
+                board.SetPiece(cell, turn);
+                const TicTacToe::Piece winner = checkWholeBoard ? board.IsThereAWinner() : board.CheckWinAt(cell);
+                if (winner != TicTacToe::Piece::Empty)
+                    ++wins;
+                else if (board.IsFull())
+                    ++wins;
+                turn = turn == TicTacToe::Piece::X ? TicTacToe::Piece::O : TicTacToe::Piece::X;
+            }
+            moves += game.size();
+        }
+
+        const double seconds = measure.GetSeconds();
+        std::cout << std::left << std::setw(32) << name << std::right << std::setw(8) << std::fixed << std::setprecision(1)
+            << seconds * 1e9 / moves << " ns/move" << std::setw(8) << std::setprecision(2)
+            << measure.GetAllocationsPer(moves) << " alloc/move" << std::endl;
+
+        // Every game ends, keeps the loops from being optimized away
+        if (wins != games.size())
+            std::cout << "Some games did not end." << std::endl;
+    }
+
+    // Whole board scans of 15x15 Gomoku positions, with each kernel the processor supports
+    static void RunLineScan()
+    {
+        constexpr size_t WIDTH = 15, HEIGHT = 15;
+        constexpr unsigned int GOAL = 5;
+        std::cout << std::endl << SCAN_POSITIONS << " positions of " << WIDTH << "x" << HEIGHT << ", " << GOAL
+            << " in a row, scanned " << SCAN_REPEATS << " times." << std::endl;
+
+        // Mid games: a third of the cells played
+        std::mt19937 random(7);
+        std::vector<TicTacToe::RowBitboard> positions(SCAN_POSITIONS, TicTacToe::RowBitboard(WIDTH, HEIGHT, GOAL));
+        for (auto& position : positions)
+        {
+            for (size_t move = 0; move < WIDTH * HEIGHT / 3; ++move)
+            {
+                position.Set(random() % HEIGHT, random() % WIDTH, 1 + move % 2);
+            }
+        }
+
+        const std::pair<TicTacToe::ScanKernel, const char*> kernels[] = {
+            { TicTacToe::ScanKernel::Scalar, "Scalar (4 rows)" },
+            { TicTacToe::ScanKernel::Sse2, "SSE2 (8 rows)" },
+            { TicTacToe::ScanKernel::Avx2, "AVX2 (16 rows)" },
+        };
+        for (const auto& [kernel, name] : kernels)
+        {
+            if (!TicTacToe::IsScanKernelSupported(kernel))
+            {
+                std::cout << std::left << std::setw(32) << name << "not supported" << std::endl;
+                continue;
+            }
+
+            size_t threats = 0;
+            Measure measure;
+            for (size_t repeat = 0; repeat < SCAN_REPEATS; ++repeat)
+            {
+                for (const auto& position : positions)
+                {
+                    const TicTacToe::LineScan scan = position.Scan(kernel);
+                    threats += scan.Threats[0] + scan.Threats[1];
+                }
+            }
+
+            const double seconds = measure.GetSeconds();
+            std::cout << std::left << std::setw(32) << name << std::right << std::setw(8) << std::fixed << std::setprecision(1)
+                << seconds * 1e9 / (SCAN_POSITIONS * SCAN_REPEATS) << " ns/scan" << std::setw(10)
+                << threats / SCAN_REPEATS << " threats" << (kernel == TicTacToe::GetBestScanKernel() ? "  (used)" : "") << std::endl;
+        }
+    }
+
+    void RunBoard()
+    {
+        std::cout << BOARD_GAMES << " random games per board, one move checked at a time." << std::endl;
+
+        const GameMoves classicGames = MakeGames(DEFAULT_BOARD_ARGS);
+        {
+            TicTacToe::DynamicBoard dynamicBoard(DEFAULT_BOARD_ARGS);
+            TicTacToe::ClassicBoard fixedBoard;
+            TicTacToe::Board board;
+            RunBoard("3x3 DynamicBoard", dynamicBoard, classicGames, false);
+            RunBoard("3x3 FixedBoard", fixedBoard, classicGames, false);
+            RunBoard("3x3 Board (virtual FixedBoard)", board, classicGames, false);
+            RunBoard("3x3 DynamicBoard, whole board", dynamicBoard, classicGames, true);
+            RunBoard("3x3 FixedBoard, whole board", fixedBoard, classicGames, true);
+        }
+
+        // A size without a FixedBoard instance, for comparison
+        const GameMoves largeGames = MakeGames(8, 8, 5);
+        {
+            TicTacToe::DynamicBoard dynamicBoard(8, 8, 5);
+            TicTacToe::FixedBoard<8, 8, 5> fixedBoard;
+            RunBoard("8x8 DynamicBoard", dynamicBoard, largeGames, false);
+            RunBoard("8x8 FixedBoard", fixedBoard, largeGames, false);
+        }
+
+        RunLineScan();
+    }
+}
@@ -0,0 +1,171 @@
+#include "Benchmark.h"
+#include <tcp-ip/MessageCodec.h>
+#include <iomanip>
+
+namespace Benchmark
+{
+    constexpr size_t CODEC_ITERATIONS = 200000;
+
+    static void PrintCodecResult(const char* step, size_t count, const Measure& measure)
+    {
+        std::cout << std::setw(10) << std::fixed << std::setprecision(0) << measure.GetSeconds() * 1e9 / count << " ns " << step
+            << std::setw(6) << std::setprecision(1) << measure.GetAllocationsPer(count) << " alloc";
+    }
+
+    // How JSON messages were read before JsonReader: parse a document, then copy its values into the message
+    template <typename T>
+    static void ReadFromDocument(const nlohmann::json& json, T& value)
+    {
+        if constexpr (HasFields<T>)
+        {
+            if (!json.is_object())
+                throw std::runtime_error("JSON value is not an object");
+            std::apply([&](const auto&... fields)
+            {
+                ([&]
+                {
+                    const auto it = json.find(fields.Name);
+                    if (it != json.end())
+                        ReadFromDocument(*it, value.*fields.Member);
+                    else if (!fields.IsOptional)
+                        throw std::runtime_error("JSON object is missing a field");
+                }(), ...);
+            }, T::GetFields());
+        }
+        else if constexpr (Serializer::IsVector<T>::value)
+        {
+            if (!json.is_array())
+                throw std::runtime_error("JSON value is not an array");
+            value.resize(json.size());
+            for (size_t i = 0; i < value.size(); ++i)
+            {
+                ReadFromDocument(json[i], value[i]);
+            }
+        }
+        else if constexpr (std::is_enum_v<T>)
+            value = static_cast<T>(json.get<std::underlying_type_t<T>>());
+        else
+            value = json.get<T>();
+    }
+
+    // Encode the message, then read it back like the receiving side does: type first, then the fields
+    template <MsgType T>
+    static void RunCodec(const char* name, const Message<T>& message)
+    {
+        size_t sink = 0;
+        for (const MessageEncoding encoding : {MessageEncoding::Json, MessageEncoding::Binary})
+        {
+            const std::string encoded = EncodeMessage(message, encoding);
+            std::cout << std::left << std::setw(16) << name << std::setw(8) << (encoding == MessageEncoding::Json ? "JSON" : "binary")
+                << std::right << std::setw(6) << encoded.size() << " B";
+
+            {
+                // Into a reused buffer, like a send buffer would be
+                std::string buffer;
+                Measure measure;
+                for (size_t i = 0; i < CODEC_ITERATIONS; ++i)
+                {
+                    buffer.clear();
+                    EncodeMessage(message, encoding, buffer);
+                    sink += buffer.size();
+                }
+                PrintCodecResult("encode", CODEC_ITERATIONS, measure);
+            }
+            {
+                Measure measure;
+                for (size_t i = 0; i < CODEC_ITERATIONS; ++i)
+                {
+                    const ReceivedMessage received(encoded);
+                    [[maybe_unused]] const Message<T> decoded = received.As<T>();
+                    sink += static_cast<size_t>(received.GetType());
+                }
+                PrintCodecResult("decode", CODEC_ITERATIONS, measure);
+            }
+            if (encoding == MessageEncoding::Json)
+            {
+                Measure measure;
+                for (size_t i = 0; i < CODEC_ITERATIONS; ++i)
+                {
+                    const nlohmann::json document = nlohmann::json::parse(encoded);
+                    Message<T> decoded;
+                    ReadFromDocument(document, decoded);
+                    sink += document.size();
+                }
+                PrintCodecResult("DOM decode", CODEC_ITERATIONS, measure);
+            }
+            std::cout << std::endl;
+        }
+
+        // Keeps the loops from being optimized away
+        if (sink == 0)
+            std::cout << "Nothing was encoded." << std::endl;
+    }
+
+    void RunCodec()
+    {
+        std::cout << CODEC_ITERATIONS << " encodes and decodes per message and encoding." << std::endl;
+
+        Message<MsgType::MakeMove> makeMove;
+        makeMove.LobbyId = 4;
+        makeMove.Cell = 7;
+        makeMove.Piece = TicTacToe::Piece::O;
+        RunCodec("MakeMove", makeMove);
+
+        Message<MsgType::AcceptMakeMove> acceptMakeMove;
+        acceptMakeMove.Cell = 7;
+        acceptMakeMove.Piece = TicTacToe::Piece::O;
+        RunCodec("AcceptMakeMove", acceptMakeMove);
+
+        // The lobbies of the server, half of them with players
+        Message<MsgType::LobbyList> lobbyList;
+        for (int i = 0; i < 6; ++i)
+        {
+            lobbyList.LobbiesData.emplace_back(1000 + i, i <= 2 ? CLASSIC : FAST, i % 2 ? "Player" + std::to_string(i) : "", i % 4 ? "" : "Opponent");
+        }
+        RunCodec("LobbyList", lobbyList);
+
+        // Data the server drops: the stream stops at an unknown type or at the first error, the document is parsed whole
+        std::cout << std::endl << "Rejected JSON, type read with JsonReader then with a parsed document." << std::endl;
+        const std::pair<const char*, std::string> rejected[] = {
+            { "Unknown type", R"({"Type":99,"Lobbies":[{"ID":1000,"GameMode":0,"PlayerX":"Player1","PlayerO":"Opponent"}]})" },
+            { "Malformed", R"({"Type":8,"ID":4,"Cell":7,"Piece":2,)" },
+        };
+        for (const auto& [name, data] : rejected)
+        {
+            std::cout << std::left << std::setw(16) << name << std::setw(8) << "JSON" << std::right << std::setw(6) << data.size() << " B";
+            size_t sink = 0;
+            {
+                Measure measure;
+                for (size_t i = 0; i < CODEC_ITERATIONS; ++i)
+                {
+                    try
+                    {
+                        // Like the server: the fields are only read for a known type
+                        const ReceivedMessage received(data);
+                        if (received.GetType() == MsgType::MakeMove)
+                            [[maybe_unused]] const Message<MsgType::MakeMove> decoded = received.As<MsgType::MakeMove>();
+                        sink += static_cast<size_t>(received.GetType());
+                    }
+                    catch (const std::exception&) { ++sink; }
+                }
+                PrintCodecResult("stream", CODEC_ITERATIONS, measure);
+            }
+            {
+                Measure measure;
+                for (size_t i = 0; i < CODEC_ITERATIONS; ++i)
+                {
+                    try
+                    {
+                        sink += nlohmann::json::parse(data)["Type"].get<unsigned int>();
+                    }
+                    catch (const std::exception&) { ++sink; }
+                }
+                PrintCodecResult("DOM", CODEC_ITERATIONS, measure);
+            }
+            std::cout << std::endl;
+
+            if (sink == 0)
+                std::cout << "Nothing was read." << std::endl;
+        }
+    }
+}
@@ -0,0 +1,134 @@
+#include "Benchmark.h"
+#include "src/tcp-ip/TcpIpServer.h"
+#include <tcp-ip/FrameDecoder.h>
+#include <iomanip>
+#include <thread>
+
+namespace Benchmark
+{
+    using enum TcpIp::ErrorCode;
+
+    constexpr unsigned int REACTOR_PORT = DEFAULT_PORT + 2;
+    constexpr size_t REACTOR_CLIENT_THREADS = 4;
+    constexpr size_t REACTOR_CLIENTS_PER_THREAD = 8;
+    constexpr size_t REACTOR_MESSAGES_PER_CLIENT = 2000;
+    // Large enough for all the replies of a client, it only reads them at the end
+    constexpr size_t REACTOR_KICK_THRESHOLD = 4 * 1024 * 1024;
+
+    static SOCKET ConnectToReactor()
+    {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(REACTOR_PORT);
+
+        SOCKET clientSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (clientSocket == INVALID_SOCKET)
+            throw TcpIp::TcpIpException::Create(SOCKET_CreateFailed, TCP_IP_WSA_ERROR);
+        if (connect(clientSocket, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR)
+            throw TcpIp::TcpIpException::Create(SOCKET_ConnectFailed, TCP_IP_WSA_ERROR);
+        return clientSocket;
+    }
+
+    // Send every message of every client, then wait for all the replies.
+    static void RunReactorClients()
+    {
+        std::vector<SOCKET> sockets;
+        for (size_t i = 0; i < REACTOR_CLIENTS_PER_THREAD; ++i)
+        {
+            sockets.push_back(ConnectToReactor());
+        }
+
+        const std::string message = R"({"Type":8,"LobbyID":3,"Cell":4,"Padding":"0123456789012345678901234567890123456789"})";
+        for (size_t i = 0; i < REACTOR_MESSAGES_PER_CLIENT; ++i)
+        {
+            for (SOCKET clientSocket : sockets)
+            {
+                TcpIp::Send(clientSocket, message.c_str(), static_cast<u_long>(message.size()), {8, 0});
+            }
+        }
+
+        TcpIp::FrameDecoder decoder;
+        TcpIp::Frame reply;
+        for (SOCKET clientSocket : sockets)
+        {
+            size_t replies = 0;
+            while (replies < REACTOR_MESSAGES_PER_CLIENT)
+            {
+                char* buffer = decoder.Prepare(DEFAULT_BUFFER_SIZE);
+                int received = recv(clientSocket, buffer, DEFAULT_BUFFER_SIZE, 0);
+                if (received <= 0)
+                    throw TcpIp::TcpIpException::Create(RECEIVE_DataFailed, TCP_IP_WSA_ERROR);
+                decoder.Commit(received);
+
+                while (decoder.Next(reply))
+                {
+                    ++replies;
+                }
+            }
+            TcpIp::CloseSocket(clientSocket);
+        }
+    }
+
+    void RunReactor()
+    {
+        const size_t total = REACTOR_CLIENT_THREADS * REACTOR_CLIENTS_PER_THREAD * REACTOR_MESSAGES_PER_CLIENT;
+        std::cout << REACTOR_CLIENT_THREADS * REACTOR_CLIENTS_PER_THREAD << " clients, " << total << " messages, "
+            << std::thread::hardware_concurrency() << " hardware threads." << std::endl;
+
+        // Woken up by the I/O threads, like the main loop of ServerApp
+        IReadinessBackend* loopBackend = IReadinessBackend::Create();
+        std::vector<ReadyEvent> readyEvents;
+
+        for (unsigned int ioThreads : {1u, 2u, 4u})
+        {
+            TcpIpServer server;
+            server.SetWakeTarget(loopBackend);
+            OutboundSettings settings;
+            settings.KickThreshold = REACTOR_KICK_THRESHOLD;
+            server.SetOutboundSettings(settings);
+            server.Open(REACTOR_PORT, ioThreads);
+
+            Measure measure;
+            std::vector<std::thread> clients;
+            for (size_t i = 0; i < REACTOR_CLIENT_THREADS; ++i)
+            {
+                clients.emplace_back(RunReactorClients);
+            }
+
+            // What the game thread does for every message: parse it, and answer
+            size_t handled = 0;
+            while (handled < total)
+            {
+                loopBackend->Poll(readyEvents, server.HasDeferredData() ? 0 : -1);
+                server.CheckNetwork();
+                while (server.FindNewClient() != nullptr) {}
+
+                ClientPtr sender;
+                while ((sender = server.FindClientWithPendingData()) != nullptr)
+                {
+                    for (const TcpIp::Frame& frame : sender->Receive())
+                    {
+                        nlohmann::json parsed = nlohmann::json::parse(frame.Data);
+                        parsed["Type"] = 16;
+                        sender->Send(parsed.dump(), {16, 0});
+                        ++handled;
+                    }
+                }
+                server.CleanClosedConnections();
+            }
+
+            for (std::thread& client : clients)
+            {
+                client.join();
+            }
+
+            const double seconds = measure.GetSeconds();
+            std::cout << std::setw(2) << ioThreads << " I/O thread" << (ioThreads > 1 ? "s" : " ")
+                << std::setw(12) << std::fixed << std::setprecision(0) << total / seconds << " msg/s"
+                << std::setw(10) << std::setprecision(2) << measure.GetAllocationsPer(total) << " alloc/msg"
+                << std::endl;
+        }
+        delete loopBackend;
+    }
+}
@@ -0,0 +1,130 @@
+#include "Benchmark.h"
+#include "src/tcp-ip/OutboundQueue.h"
+#include <tcp-ip/MessageCodec.h>
+#include <cstring>
+#include <iomanip>
+#include <thread>
+
+namespace Benchmark
+{
+    using enum TcpIp::ErrorCode;
+
+    // The send path as it was before vectored sends: one heap header, one heap copy of header + data.
+    static void LegacySend(const SOCKET& socket, const char* data, const u_long size)
+    {
+        char* header = new char[TcpIp::HEADER_SIZE];
+        TcpIp::WriteHeader(header, size, {});
+
+        char* buffer = new char[TcpIp::HEADER_SIZE + size];
+        memcpy(buffer, header, TcpIp::HEADER_SIZE);
+        delete[] header;
+
+        memcpy(buffer + TcpIp::HEADER_SIZE, data, size);
+        int iResult = send(socket, buffer, TcpIp::HEADER_SIZE + static_cast<int>(size), TCP_IP_SEND_FLAGS);
+        delete[] buffer;
+
+        if (iResult == SOCKET_ERROR)
+            throw TcpIp::TcpIpException::Create(SEND_DataFailed, TCP_IP_WSA_ERROR);
+    }
+
+    constexpr size_t BROADCAST_RECIPIENTS = 64;
+    constexpr size_t BROADCAST_COUNT = 20000;
+
+    static void PrintResult(const char* path, size_t payloadSize, size_t count, const Measure& measure)
+    {
+        const double seconds = measure.GetSeconds();
+        const double bytes = static_cast<double>((payloadSize + TcpIp::HEADER_SIZE) * count);
+        std::cout << std::left << std::setw(20) << path
+            << std::right << std::setw(8) << payloadSize << " B"
+            << std::setw(12) << std::fixed << std::setprecision(1) << bytes / seconds / (1024 * 1024) << " MiB/s"
+            << std::setw(12) << std::setprecision(0) << count / seconds << " msg/s"
+            << std::setw(10) << std::setprecision(2) << measure.GetAllocationsPer(count) << " alloc/msg"
+            << std::endl;
+    }
+
+    // One encode per broadcast, then a frame per connection (what Connection::Send does with unframed data), or one shared frame
+    template <MsgType T>
+    static void RunBroadcast(const char* name, const Message<T>& message, OutboundQueue& queue, const SOCKET& socket)
+    {
+        const size_t sends = BROADCAST_COUNT * BROADCAST_RECIPIENTS;
+        const size_t size = EncodeMessage(message, MessageEncoding::Binary).size();
+        std::cout << name << std::endl;
+        {
+            Measure measure;
+            for (size_t i = 0; i < BROADCAST_COUNT; ++i)
+            {
+                const std::string encoded = EncodeMessage(message, MessageEncoding::Binary);
+                for (size_t j = 0; j < BROADCAST_RECIPIENTS; ++j)
+                    queue.Push(socket, MakeFrame(encoded, GetFrameInfo<T>(MessageEncoding::Binary)));
+            }
+            PrintResult("copy per connection", size, sends, measure);
+        }
+        {
+            Measure measure;
+            for (size_t i = 0; i < BROADCAST_COUNT; ++i)
+            {
+                BroadcastMessage<T> encoded(message);
+                for (size_t j = 0; j < BROADCAST_RECIPIENTS; ++j)
+                    queue.Push(socket, encoded.Get(MessageEncoding::Binary));
+            }
+            PrintResult("shared frame", size, sends, measure);
+        }
+    }
+
+    void RunSend()
+    {
+        SOCKET clientSide, serverSide;
+        CreateLoopbackPair(clientSide, serverSide);
+
+        // Read everything on the other side, so the sender never blocks on a full buffer
+        std::thread drain([clientSide]()
+            {
+                char buffer[64 * 1024];
+                while (recv(clientSide, buffer, sizeof(buffer), 0) > 0) {}
+            });
+
+        // What the I/O thread of a connection does with a message given to Connection::Send
+        std::cout << "OutboundQueue::Push sends directly while the queue is empty." << std::endl;
+        OutboundQueue queue;
+
+        constexpr size_t BYTES_PER_RUN = 256 * 1024 * 1024;
+        for (size_t payloadSize : {64, 512, 4096, 65536})
+        {
+            const std::string payload(payloadSize, 'x');
+            const SharedFrame frame = MakeFrame(payload, {});
+            const size_t count = BYTES_PER_RUN / payloadSize / 8;
+
+            {
+                Measure measure;
+                for (size_t i = 0; i < count; ++i)
+                    LegacySend(serverSide, payload.c_str(), static_cast<u_long>(payload.size()));
+                PrintResult("before (copy)", payloadSize, count, measure);
+            }
+            {
+                Measure measure;
+                for (size_t i = 0; i < count; ++i)
+                    queue.Push(serverSide, frame);
+                PrintResult("after (pre-framed)", payloadSize, count, measure);
+            }
+        }
+
+        // A lobby move and a lobby list refresh, sent to many connections (all on the same socket here)
+        std::cout << std::endl << "Broadcast to " << BROADCAST_RECIPIENTS << " connections, encoded once." << std::endl;
+        Message<MsgType::AcceptMakeMove> acceptMakeMove;
+        acceptMakeMove.Cell = 4;
+        acceptMakeMove.Piece = TicTacToe::Piece::X;
+        RunBroadcast("AcceptMakeMove", acceptMakeMove, queue, serverSide);
+
+        Message<MsgType::LobbyList> lobbyList;
+        for (int i = 0; i < 6; ++i)
+        {
+            lobbyList.LobbiesData.emplace_back(1000 + i, i <= 2 ? CLASSIC : FAST, i % 2 ? "Player" + std::to_string(i) : "", "");
+        }
+        RunBroadcast("LobbyList", lobbyList, queue, serverSide);
+
+        shutdown(serverSide, SD_SEND);
+        drain.join();
+        TcpIp::CloseSocket(serverSide);
+        TcpIp::CloseSocket(clientSide);
+    }
+}
@@ -0,0 +1,78 @@
+#include "Benchmark.h"
+#include "src/core/TimerWheel.h"
+#include <iomanip>
+#include <thread>
+
+namespace Benchmark
+{
+    constexpr size_t TIMER_GAMES = 50000;
+    constexpr size_t TIMER_MOVES_PER_GAME = 20;
+    // A FAST turn and its grace time
+    constexpr auto TIMER_TURN_TIME = std::chrono::milliseconds(2000);
+    constexpr auto TIMER_SPREAD = std::chrono::milliseconds(1000);
+
+    void RunTimers()
+    {
+        std::cout << TIMER_GAMES << " FAST games, " << TIMER_MOVES_PER_GAME << " moves each." << std::endl;
+
+        TimerWheel wheel;
+        std::vector<TimerWheel::TimerId> turnTimers(TIMER_GAMES, TimerWheel::INVALID_TIMER);
+        size_t expired = 0;
+
+        // Every move restarts the clock of its game: one cancel and one schedule
+        {
+            Measure measure;
+            for (size_t move = 0; move < TIMER_MOVES_PER_GAME; ++move)
+            {
+                for (size_t game = 0; game < TIMER_GAMES; ++game)
+                {
+                    wheel.Cancel(turnTimers[game]);
+                    turnTimers[game] = wheel.Schedule(TIMER_TURN_TIME, [&expired]() { ++expired; });
+                }
+            }
+
+            const double seconds = measure.GetSeconds();
+            const size_t restarts = TIMER_GAMES * TIMER_MOVES_PER_GAME;
+            std::cout << "Restart turn clock" << std::setw(12) << std::fixed << std::setprecision(0) << restarts / seconds << " /s"
+                << std::setw(10) << std::setprecision(2) << measure.GetAllocationsPer(restarts) << " alloc/op" << std::endl;
+        }
+
+        // Spread the deadlines, then let them all expire while the loop sleeps like ServerApp does
+        for (size_t game = 0; game < TIMER_GAMES; ++game)
+        {
+            wheel.Cancel(turnTimers[game]);
+            turnTimers[game] = wheel.Schedule(TIMER_SPREAD * game / TIMER_GAMES, [&expired]() { ++expired; });
+        }
+
+        double wheelSeconds = 0;
+        size_t wakeUps = 0;
+        while (wheel.GetCount() > 0)
+        {
+            const int timeout = wheel.GetTimeoutMs();
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+
+            Measure measure;
+            wheel.Advance();
+            wheelSeconds += measure.GetSeconds();
+            ++wakeUps;
+        }
+
+        // What the loop would cost by scanning the deadline of every game on each wake up instead
+        std::vector<std::chrono::steady_clock::time_point> deadlines(TIMER_GAMES, std::chrono::steady_clock::now() + TIMER_TURN_TIME);
+        size_t due = 0;
+        Measure scan;
+        for (size_t wakeUp = 0; wakeUp < wakeUps; ++wakeUp)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            for (const auto& deadline : deadlines)
+            {
+                due += deadline <= now;
+            }
+        }
+        const double scanSeconds = scan.GetSeconds();
+
+        std::cout << "Expired " << expired << " timers in " << wakeUps << " wake ups." << std::endl;
+        std::cout << "Timer wheel  " << std::setw(10) << std::setprecision(3) << wheelSeconds * 1000 << " ms spent advancing" << std::endl;
+        std::cout << "Scan all     " << std::setw(10) << std::setprecision(3) << scanSeconds * 1000 << " ms spent scanning (" << due << " due)" << std::endl;
+    }
+}
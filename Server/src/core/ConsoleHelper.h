@@ -1,5 +1,15 @@
 #pragma once
+#ifdef _WIN32
 #include <conio.h>
+#else
+#include <termios.h>
+
+// Same values as the Windows console attributes
+#define FOREGROUND_BLUE 0x1
+#define FOREGROUND_GREEN 0x2
+#define FOREGROUND_RED 0x4
+#define FOREGROUND_INTENSITY 0x8
+#endif
 
 enum class Color
 {
@@ -24,7 +34,7 @@ enum class Color
 /// <summary>
 /// Hash a string to a color.
 /// </summary>
-Color HshClr(const std::string& str)
+inline Color HshClr(const std::string& str)
 {
     int hash = 0;
     for (char c : str)
@@ -37,17 +47,51 @@ Color HshClr(const std::string& str)
 // Example: std::cout << Color::Red << "Hello World!" << Color::White;
 inline std::ostream& operator<<(std::ostream& os, Color clr)
 {
+#ifdef _WIN32
     SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), static_cast<WORD>(clr));
+#else
+    // Console attributes are BGR, ANSI colors are RGB
+    const int value = static_cast<int>(clr);
+    const int ansi = (value & FOREGROUND_RED ? 1 : 0) | (value & FOREGROUND_GREEN ? 2 : 0) | (value & FOREGROUND_BLUE ? 4 : 0);
+    os << "\033[" << (value & FOREGROUND_INTENSITY ? 90 : 30) + ansi << 'm';
+#endif
     return os;
 }
 
+#ifndef _WIN32
+/// <summary>
+/// Put the terminal in non-canonical mode, so key presses can be read without waiting for ENTER.
+/// </summary>
+struct RawTerminal
+{
+    RawTerminal()
+    {
+        tcgetattr(0, &Original);
+        termios raw = Original;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        tcsetattr(0, TCSANOW, &raw);
+    }
+    ~RawTerminal() { tcsetattr(0, TCSANOW, &Original); }
+
+    termios Original;
+};
+#endif
+
 /// <summary>
-/// Check if a key is pressed.
+/// Block until a key is pressed.
 /// </summary>
-inline bool IsKeyPressed(char key)
+/// <returns>False if there is no console input to read the key from.</returns>
+inline bool WaitForKey(char key)
 {
-    while (_kbhit())
-        if (_getch() == key)
+#ifdef _WIN32
+    while (_getch() != key) {}
+    return true;
+#else
+    static RawTerminal terminal;
+    char c;
+    while (read(0, &c, 1) == 1)
+        if (c == key)
             return true;
     return false;
+#endif
 }
@@ -0,0 +1,46 @@
+#include "LatencyReport.h"
+#include <algorithm>
+#include <iomanip>
+
+static double ToMicroseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+void LatencyReport::Print(std::ostream& os) const
+{
+    os << "Wakeup to handle latency, " << m_Samples.size() << " samples." << std::endl;
+    if (m_Samples.empty())
+        return;
+
+    std::vector<std::chrono::steady_clock::duration> sorted = m_Samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto percentile = [&sorted](double p) { return sorted[static_cast<size_t>(p * (sorted.size() - 1))]; };
+    os << std::fixed << std::setprecision(1)
+        << "  min " << ToMicroseconds(sorted.front()) << " us"
+        << ", p50 " << ToMicroseconds(percentile(0.50)) << " us"
+        << ", p90 " << ToMicroseconds(percentile(0.90)) << " us"
+        << ", p99 " << ToMicroseconds(percentile(0.99)) << " us"
+        << ", p99.9 " << ToMicroseconds(percentile(0.999)) << " us"
+        << ", max " << ToMicroseconds(sorted.back()) << " us" << std::endl;
+
+    // Upper bounds of the histogram buckets, in microseconds. The last bucket has no bound.
+    constexpr double bounds[] = {10, 50, 100, 250, 500, 1000, 2000, 5000, 15000};
+    size_t sample = 0;
+    for (size_t i = 0; i <= std::size(bounds); ++i)
+    {
+        size_t count = 0;
+        while (sample < sorted.size() && (i == std::size(bounds) || ToMicroseconds(sorted[sample]) < bounds[i]))
+        {
+            ++count;
+            ++sample;
+        }
+
+        if (i < std::size(bounds))
+            os << "  < " << std::setw(6) << std::setprecision(0) << bounds[i] << " us: ";
+        else
+            os << "  >= " << std::setw(5) << std::setprecision(0) << bounds[i - 1] << " us: ";
+        os << std::setw(8) << count << "  " << std::string(count * 50 / sorted.size(), '#') << std::endl;
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+/// <summary>
+/// Collects the time between an I/O thread posting messages and the game thread handling them,
+/// and prints their distribution. (`Server --latency`)
+/// </summary>
+class LatencyReport final
+{
+public:
+    void Add(std::chrono::steady_clock::duration latency) { m_Samples.push_back(latency); }
+    size_t GetCount() const { return m_Samples.size(); }
+
+    /// <summary>
+    /// Print the percentiles and a histogram of the samples.
+    /// </summary>
+    void Print(std::ostream& os) const;
+
+private:
+    std::vector<std::chrono::steady_clock::duration> m_Samples;
+};
@@ -0,0 +1,95 @@
+#include "LobbyListCache.h"
+#include <algorithm>
+
+void LobbyListCache::Record(LobbyChange change, const LobbyData& lobby)
+{
+    ++m_Version;
+    if (m_History.size() == MAX_HISTORY)
+        m_History.pop_front();
+
+    Change& recorded = m_History.emplace_back();
+    recorded.Version = m_Version;
+    recorded.Lobby.Change = change;
+    if (change == LobbyChange::Closed)
+        recorded.Lobby.Data.ID = lobby.ID;
+    else
+        recorded.Lobby.Data = lobby;
+}
+
+const SharedFrame& LobbyListCache::Get(MessageEncoding encoding)
+{
+    Snapshot& snapshot = m_Snapshots[static_cast<size_t>(encoding)];
+    if (snapshot.Version == m_Version)
+        return snapshot.Data;
+
+    Message<MsgType::LobbyList> message;
+    message.LobbiesData.reserve(m_Lobbies.size());
+    for (const Lobby* lobby : m_Lobbies)
+    {
+        message.LobbiesData.emplace_back(lobby->Data);
+    }
+    message.Version = m_Version;
+
+    // A new buffer: the previous one may still be queued on slow connections
+    snapshot.Data = std::make_shared<const std::string>(EncodeFrame(message, encoding));
+    snapshot.Version = m_Version;
+    return snapshot.Data;
+}
+
+SharedFrame LobbyListCache::GetDelta(unsigned int baseVersion, MessageEncoding encoding)
+{
+    // The changes after the base must all still be in the history
+    const unsigned int oldestBase = m_History.empty() ? m_Version : m_History.front().Version - 1;
+    if (baseVersion == 0 || baseVersion < oldestBase || baseVersion > m_Version)
+        return nullptr;
+
+    if (m_DeltasVersion != m_Version)
+    {
+        for (std::vector<Delta>& deltas : m_Deltas)
+        {
+            deltas.clear();
+        }
+        m_DeltasVersion = m_Version;
+    }
+
+    std::vector<Delta>& deltas = m_Deltas[static_cast<size_t>(encoding)];
+    for (const Delta& delta : deltas)
+    {
+        if (delta.BaseVersion == baseVersion)
+            return delta.Data;
+    }
+
+    Delta& delta = deltas.emplace_back();
+    delta.BaseVersion = baseVersion;
+    delta.Data = std::make_shared<const std::string>(EncodeFrame(MakeDelta(baseVersion), encoding));
+    return delta.Data;
+}
+
+Message<MsgType::RefreshLobbyList> LobbyListCache::MakeDelta(unsigned int baseVersion) const
+{
+    Message<MsgType::RefreshLobbyList> message;
+    message.BaseVersion = baseVersion;
+    message.Version = m_Version;
+
+    using enum LobbyChange;
+    for (const Change& change : m_History)
+    {
+        if (change.Version <= baseVersion) continue;
+
+        const auto it = std::find_if(message.Changes.begin(), message.Changes.end(),
+            [&](const LobbyDelta& lobby) { return lobby.Data.ID == change.Lobby.Data.ID; });
+        if (it == message.Changes.end())
+            message.Changes.push_back(change.Lobby);
+        // Still new to the client: it never sees a lobby created then closed, the other changes are part of the creation
+        else if (it->Change == Created)
+        {
+            if (change.Lobby.Change == Closed)
+                message.Changes.erase(it);
+            else
+                it->Data = change.Lobby.Data;
+        }
+        else
+            *it = change.Lobby;
+    }
+    return message;
+}
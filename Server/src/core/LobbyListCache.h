@@ -0,0 +1,76 @@
+#pragma once
+#include "src/tcp-ip/OutboundQueue.h"
+#include "game/Lobby.h"
+#include <tcp-ip/MessageCodec.h>
+#include <deque>
+#include <vector>
+
+/// <summary>
+/// The lobby list as the clients receive it, encoded and framed once per version and per encoding.
+/// Every send of a version shares the same immutable buffer, a refresh to all players costs one encode.
+/// Record every change of a lobby: the version grows by one, and the recent changes are kept
+/// to send clients only the lobbies that changed since the version they have.
+/// </summary>
+class LobbyListCache final
+{
+public:
+    explicit LobbyListCache(const std::vector<Lobby*>& lobbies) : m_Lobbies(lobbies) {}
+    LobbyListCache(const LobbyListCache&) = delete;
+    LobbyListCache& operator=(const LobbyListCache&) = delete;
+
+    /// <summary>
+    /// Record a change of a lobby, with its data after the change. Nothing is encoded until it is needed.
+    /// </summary>
+    void Record(LobbyChange change, const LobbyData& lobby);
+    /// <summary>
+    /// Return the version of the list, it grows by one with each change.
+    /// </summary>
+    unsigned int GetVersion() const { return m_Version; }
+
+    /// <summary>
+    /// Return the LobbyList frame of the current version.
+    /// Buffers of older versions stay valid until their last send is done.
+    /// </summary>
+    const SharedFrame& Get(MessageEncoding encoding);
+    /// <summary>
+    /// Return the RefreshLobbyList frame from a version to the current one.
+    /// </summary>
+    /// <returns>nullptr if the changes since that version are no longer known, the whole list has to be sent.</returns>
+    SharedFrame GetDelta(unsigned int baseVersion, MessageEncoding encoding);
+
+private:
+    // Changes kept for the deltas, a client further behind gets the whole list
+    static constexpr size_t MAX_HISTORY = 64;
+
+    struct Snapshot
+    {
+        // 0 until the first encode, versions start at 1
+        unsigned int Version = 0;
+        SharedFrame Data;
+    };
+    struct Delta
+    {
+        unsigned int BaseVersion = 0;
+        SharedFrame Data;
+    };
+    struct Change
+    {
+        // The version this change created
+        unsigned int Version = 0;
+        LobbyDelta Lobby;
+    };
+
+    /// <summary>
+    /// Merge the changes made after a version, one per lobby.
+    /// </summary>
+    Message<MsgType::RefreshLobbyList> MakeDelta(unsigned int baseVersion) const;
+
+    const std::vector<Lobby*>& m_Lobbies;
+    unsigned int m_Version = 1;
+    Snapshot m_Snapshots[MESSAGE_ENCODING_COUNT];
+    // Oldest first, the last one created the current version
+    std::deque<Change> m_History;
+    // The deltas to the current version already encoded, most clients share the same base
+    std::vector<Delta> m_Deltas[MESSAGE_ENCODING_COUNT];
+    unsigned int m_DeltasVersion = 0;
+};
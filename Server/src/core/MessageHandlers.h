@@ -0,0 +1,74 @@
+#pragma once
+#include <tcp-ip/MessageCodec.h>
+#include <array>
+#include <chrono>
+
+/// <summary>
+/// The handlers of the received messages, in a flat table indexed by MsgType.
+/// An entry reads the message into its Message<T>, then calls a member function of Owner with it and a Context.
+/// The table can be built at compile time: dispatching a message is one index and one indirect call.
+/// </summary>
+template <typename Owner, typename Context>
+class MessageHandlers final
+{
+public:
+    template <MsgType T>
+    using Handler = void (Owner::*)(Context&, const Message<T>&);
+
+    struct Entry
+    {
+        // Reads the message and calls the handler. nullptr for the types nobody handles.
+        void (*Call)(Owner&, Context&, const ReceivedMessage&) = nullptr;
+        const char* Name = nullptr;
+        // Only logged in connections can send it
+        bool NeedsLogin = true;
+    };
+
+    /// <summary>
+    /// Set the handler of a message type.
+    /// </summary>
+    template <MsgType T, Handler<T> H>
+    constexpr MessageHandlers& On(const char* name, bool needsLogin = true)
+    {
+        m_Entries[static_cast<size_t>(T)] = { &Call<T, H>, name, needsLogin };
+        return *this;
+    }
+
+    /// <summary>
+    /// Return the entry of a message type, or nullptr if it has no handler.
+    /// </summary>
+    constexpr const Entry* Find(MsgType type) const
+    {
+        const size_t index = static_cast<size_t>(type);
+        if (index >= m_Entries.size() || !m_Entries[index].Call)
+            return nullptr;
+        return &m_Entries[index];
+    }
+
+private:
+    template <MsgType T, Handler<T> H>
+    static void Call(Owner& owner, Context& context, const ReceivedMessage& received)
+    {
+        (owner.*H)(context, received.As<T>());
+    }
+
+    std::array<Entry, MSG_TYPE_COUNT> m_Entries{};
+};
+
+/// <summary>
+/// Time spent in the handler of each message type.
+/// </summary>
+struct HandlerTiming
+{
+    size_t Count = 0;
+    std::chrono::steady_clock::duration Total{};
+    std::chrono::steady_clock::duration Max{};
+
+    void Add(std::chrono::steady_clock::duration duration)
+    {
+        ++Count;
+        Total += duration;
+        if (duration > Max)
+            Max = duration;
+    }
+};
@@ -0,0 +1,58 @@
+#include "PlayerRegistry.h"
+
+Player* PlayerRegistry::Register(ConnectionHandle connection, const std::string& name)
+{
+    if (m_PlayersByConnection.contains(connection))
+        return nullptr;
+
+    const PlayerId id = m_Players.Emplace();
+    Player* player = m_Players.Get(id);
+    player->Id = id;
+    player->Name = name;
+    player->Connection = connection;
+
+    m_PlayersByConnection[connection] = id;
+    return player;
+}
+
+void PlayerRegistry::Unregister(PlayerId id)
+{
+    Player* player = m_Players.Get(id);
+    if (!player)
+        return;
+
+    LeaveLobby(id);
+    m_PlayersByConnection.erase(player->Connection);
+    m_Players.Erase(id);
+}
+
+Player* PlayerRegistry::FindByConnection(ConnectionHandle connection)
+{
+    const auto it = m_PlayersByConnection.find(connection);
+    if (it == m_PlayersByConnection.end())
+        return nullptr;
+    return m_Players.Get(it->second);
+}
+
+void PlayerRegistry::JoinLobby(PlayerId id, Lobby* lobby)
+{
+    Player* player = m_Players.Get(id);
+    if (!player || player->CurrentLobby == lobby)
+        return;
+
+    LeaveLobby(id);
+    player->CurrentLobby = lobby;
+    lobby->Subscribe(player->Connection, player->Encoding, true);
+    ++m_CountInLobbies;
+}
+
+void PlayerRegistry::LeaveLobby(PlayerId id)
+{
+    Player* player = m_Players.Get(id);
+    if (!player || !player->CurrentLobby)
+        return;
+
+    player->CurrentLobby->Unsubscribe(player->Connection);
+    player->CurrentLobby = nullptr;
+    --m_CountInLobbies;
+}
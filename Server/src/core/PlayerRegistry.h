@@ -0,0 +1,65 @@
+#pragma once
+#include "src/tcp-ip/TcpIpServer.h"
+#include "game/Lobby.h"
+#include "tcp-ip/Message.h"
+
+/// <summary>
+/// Identifies a logged in player. Never reused, PlayerRegistry::Get returns nullptr once the player left.
+/// </summary>
+typedef SlotHandle PlayerId;
+constexpr PlayerId INVALID_PLAYER = INVALID_SLOT_HANDLE;
+
+struct Player
+{
+    PlayerId Id = INVALID_PLAYER;
+    std::string Name;
+    ConnectionHandle Connection = INVALID_CONNECTION;
+    // Chosen by the client at login, every message sent to it uses it
+    MessageEncoding Encoding = MessageEncoding::Json;
+    // The lobby the player joined, or nullptr
+    Lobby* CurrentLobby = nullptr;
+    // Version of the lobby list last sent to the client, 0 if none. Refreshes only carry the changes since then
+    unsigned int LobbyListVersion = 0;
+};
+
+/// <summary>
+/// The logged in players, indexed by id and by connection. Each lobby holds the connections of its players.
+/// Player pointers are only valid until the next Register or Unregister, keep ids instead.
+/// </summary>
+class PlayerRegistry final
+{
+public:
+    /// <summary>
+    /// Register the player of a connection.
+    /// </summary>
+    /// <returns>The new player, or nullptr if the connection already has one.</returns>
+    Player* Register(ConnectionHandle connection, const std::string& name);
+    /// <summary>
+    /// Forget a player, taking it out of its lobby first.
+    /// </summary>
+    void Unregister(PlayerId id);
+
+    Player* Get(PlayerId id) { return m_Players.Get(id); }
+    Player* FindByConnection(ConnectionHandle connection);
+
+    /// <summary>
+    /// Record that a player joined a lobby, and subscribe its connection to the lobby messages. (The lobby data is not changed)
+    /// </summary>
+    void JoinLobby(PlayerId id, Lobby* lobby);
+    /// <summary>
+    /// Record that a player left its lobby, and unsubscribe its connection. (The lobby data is not changed)
+    /// </summary>
+    void LeaveLobby(PlayerId id);
+
+    size_t GetCount() const { return m_Players.Size(); }
+    size_t GetCountInLobbies() const { return m_CountInLobbies; }
+
+    SlotMap<Player>::Iterator begin() { return m_Players.begin(); }
+    SlotMap<Player>::Iterator end() { return m_Players.end(); }
+
+private:
+    SlotMap<Player> m_Players;
+    // HashMap <Connection, Player>
+    std::unordered_map<ConnectionHandle, PlayerId> m_PlayersByConnection;
+    size_t m_CountInLobbies = 0;
+};
@@ -1,7 +1,8 @@
 #include "ServerApp.h"
 #include "ConsoleHelper.h"
-#include "tcp-ip/ClientMessages.h"
-#include "tcp-ip/ServerMessages.h"
+#include "ShutdownSignal.h"
+#include <iomanip>
+#include <thread>
 
 #define ERR_CLR Color::Red // Error color
 #define WRN_CLR Color::Yellow // Warning color
@@ -15,9 +16,43 @@
 
 
 constexpr int MAXIMUM_LOBBIES = 6;
+// Threads doing the network work of the game server. (Reading, decoding and sending messages)
+constexpr unsigned int MAXIMUM_IO_THREADS = 4;
+// Messages handled per client and per loop iteration, the rest waits for the next one so other clients get their turn
+constexpr size_t MESSAGE_BUDGET = 16;
+// Connections that did not log in by then are kicked
+constexpr auto LOGIN_TIMEOUT = std::chrono::seconds(15);
+// Messages that waited longer than this in the inbox mean the server is behind: it sheds the requests that can wait
+constexpr auto LOAD_SHEDDING_DELAY = std::chrono::milliseconds(100);
+// Added to the time of a FAST turn, for the trip of the messages. The client plays on time itself, this only catches the ones that don't.
+constexpr auto TURN_GRACE_TIME = std::chrono::milliseconds(500);
+// Name of the bot in the lobbies
+constexpr const char* BOT_NAME = "Bot";
+// The bot waits a little before playing, a reply in the same frame would be hard to follow
+constexpr auto BOT_MOVE_DELAY = std::chrono::milliseconds(300);
+// The bot has to play a FAST turn in time, its delay included.
+// The search runs on the game thread: every lobby and connection waits while it thinks. The 3x3 modes are solved
+// in under 1 ms so the budget is never used, but a larger board would stall the server for the whole budget on each
+// bot move: lower this to a few milliseconds, or search on another thread and post the move back, before adding one.
+constexpr auto MAXIMUM_BOT_THINK_TIME = std::chrono::milliseconds(1000);
+
+void ServerApp::EnableLatencyReport()
+{
+    if (!m_LatencyReport)
+        m_LatencyReport = new LatencyReport();
+}
+
+void ServerApp::EnableBot(std::chrono::milliseconds thinkTime)
+{
+    if (!m_BotEngine)
+        m_BotEngine = new TicTacToe::SearchEngine();
+    m_BotThinkTime = thinkTime < MAXIMUM_BOT_THINK_TIME ? thinkTime : MAXIMUM_BOT_THINK_TIME;
+}
 
 void ServerApp::Init()
 {
+    m_LoopBackend = IReadinessBackend::Create();
+
     if (!InitGameServer())
     {
         std::cout << ERR_CLR << "Aborting app initialization." << std::endl;
@@ -36,14 +71,28 @@ void ServerApp::Init()
 
 void ServerApp::Run()
 {
+    if (!m_GameServer)
+        return;
+
     std::cout << INF_CLR << "Press ESC to shutdown the app." << std::endl << DEF_CLR << std::endl;
-    while (!IsKeyPressed(27)) // 27 = ESC
+    ShutdownSignal::Install(m_LoopBackend);
+    while (!ShutdownSignal::IsRequested())
     {
-        HandleGameServer();
-        HandleWebServer();
+        // Sleep until there is something to do
+        try
+        {
+            m_LoopBackend->Poll(m_ReadyEvents, GetWaitTimeout());
+        }
+        catch (const TcpIp::TcpIpException& e)
+        {
+            std::cout << ERR_CLR << "The main loop has encountered an error: " << e.what() << std::endl << DEF_CLR;
+            m_ReadyEvents.clear();
+        }
 
-        // Sleep for 1ms to avoid 100% CPU usage
-        Sleep(1);
+        m_Timers.Advance();
+        HandleGameServer();
+        if (m_WebServer)
+            HandleWebServer();
     }
 }
 
@@ -53,6 +102,24 @@ void ServerApp::CleanUp()
 
     CleanUpWebServer();
     CleanUpGameServer();
+    ShutdownSignal::Uninstall();
+    RELEASE(m_LoopBackend);
+    PrintLobbyRefreshStats(std::cout);
+
+    if (m_LatencyReport)
+    {
+        m_LatencyReport->Print(std::cout);
+        PrintHandlerTimings(std::cout);
+        RELEASE(m_LatencyReport);
+    }
+}
+
+int ServerApp::GetWaitTimeout() const
+{
+    // Messages left over by the budget are handled right away
+    if (m_GameServer && m_GameServer->HasDeferredData())
+        return 0;
+    return m_Timers.GetTimeoutMs();
 }
 
 #pragma region Game Server
@@ -62,9 +129,15 @@ bool ServerApp::InitGameServer()
     std::cout << Color::Cyan << "=========== Starting Game Server Initialization ===========" << std::endl << INF_CLR;
     try
     {
+        // One per core, the game logic thread included
+        unsigned int ioThreads = std::thread::hardware_concurrency();
+        ioThreads = ioThreads > MAXIMUM_IO_THREADS ? MAXIMUM_IO_THREADS : ioThreads;
+
         m_GameServer = new TcpIpServer();
-        m_GameServer->Open(DEFAULT_PORT);
-        std::cout << "Game server is listening on port " << DEFAULT_PORT << "..." << std::endl;
+        m_GameServer->SetWakeTarget(m_LoopBackend);
+        m_GameServer->SetMessageBudget(MESSAGE_BUDGET);
+        m_GameServer->Open(DEFAULT_PORT, ioThreads);
+        std::cout << "Game server is listening on port " << DEFAULT_PORT << " with " << ioThreads << " I/O thread" << (ioThreads > 1 ? "s" : "") << "..." << std::endl;
     }
     catch (const TcpIp::TcpIpException& e)
     {
@@ -80,6 +153,12 @@ bool ServerApp::InitGameServer()
     return true;
 }
 
+// Requests that the server drops when it is behind. The client can ask again, a game can't wait.
+static bool IsSheddable(const TcpIp::FrameInfo& info)
+{
+    return !info.HasFlag(TcpIp::FRAME_PRIORITY) && info.Type == static_cast<uint8_t>(MsgType::FetchGameHistoryList);
+}
+
 void ServerApp::HandleGameServer()
 {
     try
@@ -92,33 +171,77 @@ void ServerApp::HandleGameServer()
         while ((newClient = m_GameServer->FindNewClient()) != nullptr)
         {
             std::cout << STS_CLR << "New connection from " << HASH_CLR(newClient) << STS_CLR << " has been established." << std::endl << DEF_CLR;
+
+            const ConnectionHandle handle = newClient->GetHandle();
+            m_LoginDeadlines[handle] = m_Timers.Schedule(LOGIN_TIMEOUT, [this, handle]()
+            {
+                m_LoginDeadlines.erase(handle);
+                if (const ClientPtr client = m_GameServer->GetClient(handle))
+                {
+                    std::cout << WRN_CLR << "Connection from " << HASH_CLR(client) << WRN_CLR << " did not log in, kicking it." << std::endl << DEF_CLR;
+                    client->Kick();
+                }
+            });
         }
 
         // For each client with pending data
         ClientPtr sender;
         while ((sender = m_GameServer->FindClientWithPendingData()) != nullptr)
         {
-            HandleRecv(sender);
+            const auto postedAt = sender->GetInboxTime();
+            const bool isLoaded = std::chrono::steady_clock::now() - postedAt > LOAD_SHEDDING_DELAY;
+            for (const TcpIp::Frame& frame : sender->Receive())
+            {
+                // Decided on the frame header, the data is not read for dropped frames
+                if (frame.Info.HasFlag(TcpIp::FRAME_COMPRESSED))
+                {
+                    std::cout << WRN_CLR << "Dropped a compressed message from " << HASH_CLR(sender) << WRN_CLR << ", compression is not supported." << std::endl << DEF_CLR;
+                    continue;
+                }
+                if (isLoaded && IsSheddable(frame.Info))
+                {
+                    std::cout << WRN_CLR << "Server is behind, dropped a request from " << HASH_CLR(sender) << WRN_CLR << '.' << std::endl << DEF_CLR;
+                    continue;
+                }
+
+                try
+                {
+                    HandleRecv(sender, frame);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cout << ERR_CLR << "Failed to read a message from " << HASH_CLR(sender) << ERR_CLR << ": " << e.what() << std::endl << DEF_CLR;
+                }
+            }
+
+            if (m_LatencyReport)
+                m_LatencyReport->Add(std::chrono::steady_clock::now() - postedAt);
         }
 
         // For each closed connection
         m_GameServer->CleanClosedConnections([this](ClientPtr c)
         {
-            const auto& player = m_Players[c->GetName()];
-            if (!player.empty())
+            if (const auto it = m_LoginDeadlines.find(c->GetHandle()); it != m_LoginDeadlines.end())
             {
-                bool wasInLobby = false;
-                for (const auto lb : m_Lobbies)
-                {
-                    lb->RemovePlayerFromLobby(player);
-                }
+                m_Timers.Cancel(it->second);
+                m_LoginDeadlines.erase(it);
+            }
 
-                UnregisterPlayerFromServer(player);
+            if (Player* player = m_Registry.FindByConnection(c->GetHandle()))
+            {
+                Lobby* lb = LeaveCurrentLobby(player);
+                UnregisterPlayerFromServer(player->Id);
 
-                if (wasInLobby)
+                if (lb)
+                {
+                    OnOpponentLeft(lb);
                     RefreshLobbyListToPlayers();
+                }
             }
                 std::cout << STS_CLR << "Connection from " << HASH_CLR(c) << STS_CLR << " has been closed." << std::endl << DEF_CLR;
+            if (c->GetQueuedBytes() > 0 || c->GetDroppedMessages() > 0)
+                std::cout << WRN_CLR << "It was too slow to read: " << c->GetQueuedBytes() << " bytes left unsent, "
+                          << c->GetDroppedMessages() << " messages dropped." << std::endl << DEF_CLR;
         });
     }
     catch (const TcpIp::TcpIpException& e)
@@ -127,389 +250,384 @@ void ServerApp::HandleGameServer()
     }
 }
 
-void ServerApp::UnregisterPlayerFromServer(const std::string& player)
+void ServerApp::UnregisterPlayerFromServer(PlayerId id)
 {
-    m_Players.erase(player);
-    std::cout << STS_CLR << "Unregistered player: " << HASH_STRING_CLR(player) << STS_CLR << " from server." << std::endl << DEF_CLR;
+    const Player* player = m_Registry.Get(id);
+    if (!player)
+        return;
+
+    const std::string name = player->Name;
+    m_Registry.Unregister(id);
+    std::cout << STS_CLR << "Unregistered player: " << HASH_STRING_CLR(name) << STS_CLR << " from server." << std::endl << DEF_CLR;
 }
 
-void ServerApp::RefreshLobbyListToPlayers()
+void ServerApp::SendLobbyList(ClientPtr client, unsigned int knownVersion, MessageEncoding encoding, SendPolicy policy)
 {
-    const size_t playerCount = m_Players.size();
-    unsigned int playerInLobbyCount = 0;
+    if (const SharedFrame delta = m_LobbyList.GetDelta(knownVersion, encoding))
+        client->Send(delta, policy);
+    else
+        client->Send(m_LobbyList.Get(encoding), policy);
+}
 
-    for (const auto& lobby : m_Lobbies)
+void ServerApp::RefreshLobbyListToPlayers()
+{
+    ++m_LobbyRefreshStats.Requests;
+    if (m_LobbyRefreshTimer != TimerWheel::INVALID_TIMER)
     {
-        playerInLobbyCount += lobby->PlayerCount;
+        ++m_LobbyRefreshStats.Suppressed;
+        m_IsLobbyRefreshPending = true;
+        return;
     }
 
-    // Send the lobby list to all players that are not in a lobby
-    if (playerCount > playerInLobbyCount)
-    {
-        Message<MsgType::LobbyList> toSend;
+    BroadcastLobbyList();
+    if (m_LobbyRefreshWindow.count() > 0)
+        m_LobbyRefreshTimer = m_Timers.Schedule(m_LobbyRefreshWindow, [this]() { OnLobbyRefreshWindowEnd(); });
+}
 
-        toSend.LobbiesData.reserve(m_Lobbies.size());
-        for (const auto& lb : m_Lobbies)
-        {
-            toSend.LobbiesData.emplace_back(lb->Data);
-        }
+void ServerApp::BroadcastLobbyList()
+{
+    // A player is pending while its version is behind: players in a lobby catch up when they fetch the list
+    if (m_Registry.GetCount() == m_Registry.GetCountInLobbies())
+        return;
 
-        const std::string message = toSend.Serialize().dump();
+    const unsigned int version = m_LobbyList.GetVersion();
+    size_t sent = 0;
+    for (Player& player : m_Registry)
+    {
+        if (player.CurrentLobby || player.LobbyListVersion == version) continue;
 
-        for (auto& [adressIP, player] : m_Players)
+        if (const ClientPtr client = m_GameServer->GetClient(player.Connection))
         {
-            if (IsPlayerInLobby(player)) continue;
-
-            if (const ClientPtr client = m_GameServer->GetClientByName(adressIP))
+            // Not sent rather than dropped: the player stays pending, and gets every change since its version later
+            if (client->IsCongested())
             {
-                client->Send(message);
+                ++m_LobbyRefreshStats.Deferred;
+                m_IsLobbyRefreshPending = true;
+                continue;
             }
-        }
 
-        std::cout << INF_CLR << "Refresh lobby sent to players " << std::endl << DEF_CLR;
+            SendLobbyList(client, player.LobbyListVersion, player.Encoding, SendPolicy::Critical);
+            player.LobbyListVersion = version;
+            ++sent;
+        }
     }
+
+    if (sent == 0)
+        return;
+    ++m_LobbyRefreshStats.Broadcasts;
+    m_LobbyRefreshStats.Messages += sent;
+    std::cout << INF_CLR << "Refresh lobby sent to " << sent << " players " << std::endl << DEF_CLR;
 }
 
-void ServerApp::HandleRecv(ClientPtr sender)
+void ServerApp::OnLobbyRefreshWindowEnd()
 {
-    std::string data = sender->Receive();
-    Json parsedData;
-    try
+    m_LobbyRefreshTimer = TimerWheel::INVALID_TIMER;
+    if (!m_IsLobbyRefreshPending)
+        return;
+
+    // Sends what changed during the window, the changes keep coming so the next ones are held back for another window
+    m_IsLobbyRefreshPending = false;
+    BroadcastLobbyList();
+    m_LobbyRefreshTimer = m_Timers.Schedule(m_LobbyRefreshWindow, [this]() { OnLobbyRefreshWindowEnd(); });
+}
+
+void ServerApp::PrintLobbyRefreshStats(std::ostream& os) const
+{
+    const LobbyRefreshStats& stats = m_LobbyRefreshStats;
+    os << INF_CLR << "Lobby list refreshes: " << stats.Requests << " asked, " << stats.Broadcasts << " broadcast ("
+       << stats.Messages << " messages), " << stats.Suppressed << " suppressed, " << stats.Deferred << " deferred for congested players."
+       << std::endl << DEF_CLR;
+}
+
+void ServerApp::HandleRecv(ClientPtr sender, const TcpIp::Frame& frame)
+{
+    // Throws if the data is not a message, HandleGameServer reports it
+    const ReceivedMessage received(frame.Data);
+    const MsgType type = received.GetType();
+    if (frame.Info.Type != static_cast<uint8_t>(type))
     {
-        parsedData = Json::parse(data);
+        // The header was used to route the frame, it must not hide another message
+        std::cout << WRN_CLR << "Received message from " << HASH_CLR(sender) << WRN_CLR << " does not match its frame header." << std::endl << DEF_CLR;
+        return;
     }
-    catch (const std::exception& e)
+
+    const Handlers::Entry* handler = GetHandlers().Find(type);
+    if (!handler)
     {
-        std::cout << ERR_CLR << "Failed to parse JSON from " << HASH_CLR(sender) << ERR_CLR << ": " << e.what() << std::endl << DEF_CLR;
+        std::cout << WRN_CLR << "Received message from " << HASH_CLR(sender) << WRN_CLR << " has an unknown type." << std::endl << DEF_CLR;
         return;
     }
-    MsgType type = Message<>::GetType(parsedData);
 
-    // TODO: Add safeguards before accessing members of this class. (e.g. check if the player is in a lobby before accessing m_StartedGames)
-    using enum MsgType;
-    switch (type)
+    Session session{sender, m_Registry.FindByConnection(sender->GetHandle())};
+    if (!session.SenderPlayer && handler->NeedsLogin)
     {
-    case Login:
-    {
-        Message<Login> msg(parsedData);
-        if (!m_Players.contains(sender->GetName()))
-        {
-            m_Players.insert({sender->GetName(), msg.Username});
-            std::cout << INF_CLR << "Registered player: " << HASH_STRING_CLR(msg.Username) << INF_CLR << " into server." << std::endl << DEF_CLR;
-        }
-        else
-        {
-            std::cout << WRN_CLR << "Player " << HASH_STRING_CLR(m_Players[sender->GetName()]) << WRN_CLR << " tried to login again." << std::endl << DEF_CLR;
-            return;
-        }
-        break;
+        std::cout << WRN_CLR << "Connection " << HASH_CLR(sender) << WRN_CLR << " sent a message before logging in." << std::endl << DEF_CLR;
+        return;
     }
-    case Disconnect:
+    // Replies use the encoding chosen at login, or the one of the request before that
+    session.Encoding = session.SenderPlayer ? session.SenderPlayer->Encoding : received.GetEncoding();
+
+    if (m_LatencyReport)
     {
-        std::string& username = m_Players.at(sender->GetName());
-        for (const auto& lb : m_Lobbies)
-        {
-            // If the player is in a lobby, remove him from it
-            if (lb->IsInLobby(username))
-            {
-                lb->RemovePlayerFromLobby(username);
-                std::cout << INF_CLR << "Player " << HASH_STRING_CLR(username) << INF_CLR << " has left lobby: " << lb->Data.ID << std::endl << DEF_CLR;
+        const auto start = std::chrono::steady_clock::now();
+        handler->Call(*this, session, received);
+        m_HandlerTimings[static_cast<size_t>(type)].Add(std::chrono::steady_clock::now() - start);
+    }
+    else
+        handler->Call(*this, session, received);
 
-                RefreshLobbyListToPlayers();
+    std::cout << std::endl;
+}
 
-                if (m_StartedGames.contains(lb->Data.ID) && lb->IsLobbyEmpty())
-                {
-                    m_StartedGames[lb->Data.ID] = nullptr;
-                    m_StartedGames.erase(lb->Data.ID);
-                    std::cout << INF_CLR << "Closing game " << lb->Data.ID << "..." << std::endl << DEF_CLR;
-                }
-            }
-        }
-        break;
-    }
-    case FetchLobbyList:
+const ServerApp::Handlers& ServerApp::GetHandlers()
+{
+    static constexpr Handlers handlers = Handlers()
+        .On<MsgType::Login, &ServerApp::HandleLogin>("Login", false)
+        .On<MsgType::Disconnect, &ServerApp::HandleDisconnect>("Disconnect")
+        .On<MsgType::FetchLobbyList, &ServerApp::HandleFetchLobbyList>("FetchLobbyList", false)
+        .On<MsgType::FetchGameHistoryList, &ServerApp::HandleFetchGameHistoryList>("FetchGameHistoryList", false)
+        .On<MsgType::TryToJoinLobby, &ServerApp::HandleTryToJoinLobby>("TryToJoinLobby")
+        .On<MsgType::OnEnterLobby, &ServerApp::HandleOnEnterLobby>("OnEnterLobby")
+        .On<MsgType::MakeMove, &ServerApp::HandleMakeMove>("MakeMove")
+        .On<MsgType::LeaveLobby, &ServerApp::HandleLeaveLobby>("LeaveLobby");
+    return handlers;
+}
+
+void ServerApp::PrintHandlerTimings(std::ostream& os) const
+{
+    os << "Time spent in the message handlers." << std::endl;
+    for (size_t i = 0; i < MSG_TYPE_COUNT; ++i)
     {
-        Message<LobbyList> toSend;
-        toSend.LobbiesData.reserve(m_Lobbies.size());
-        for (auto& lb : m_Lobbies)
-        {
-            toSend.LobbiesData.emplace_back(lb->Data);
-        }
-        sender->Send(toSend.Serialize().dump());
-        std::cout << INF_CLR << "Lobby list sent to " << HASH_CLR(sender) << std::endl << DEF_CLR;
-        break;
+        const HandlerTiming& timing = m_HandlerTimings[i];
+        if (timing.Count == 0)
+            continue;
+
+        const double average = std::chrono::duration<double, std::micro>(timing.Total).count() / timing.Count;
+        const double max = std::chrono::duration<double, std::micro>(timing.Max).count();
+        os << "  " << std::left << std::setw(22) << GetHandlers().Find(static_cast<MsgType>(i))->Name << std::right
+            << std::setw(8) << timing.Count << " messages, average " << std::fixed << std::setprecision(1) << average
+            << " us, max " << max << " us" << std::endl;
     }
-    case FetchGameHistoryList:
+}
+
+void ServerApp::CleanUpGameServer()
+{
+    if (!m_GameServer) return;
+
+    std::cout << Color::Cyan << "============== Starting Game Server Clean Up ==============" << std::endl;
+    try
     {
-        if (m_SavedGames.empty())
+        for (auto& c : m_GameServer->GetConnections())
         {
-            break;
+            c.Kick();
         }
 
-        Message<GameHistoryList> toSend;
-        toSend.GameHistory.reserve(m_SavedGames.size());
-        for (const auto game : m_SavedGames)
+        int count = 0;
+        m_GameServer->CleanClosedConnections([&](ClientPtr c) { ++count; });
+        if (count > 0)
+            std::cout << INF_CLR << "Closed " << count << " connection" << (count > 1 ? "s" : "") << "." << std::endl;
+
+        for (auto& [id, lobby] : m_StartedGames)
         {
-            toSend.GameHistory.push_back(game);
+            NULLPTR(lobby);
         }
+        if (!m_StartedGames.empty())
+            std::cout << INF_CLR << "Ended " << m_StartedGames.size() << " started game" << (m_StartedGames.size() > 1 ? "s" : "") << "." << std::endl;
+        m_StartedGames.clear();
+        m_TurnTimers.clear();
+        m_BotMoveTimers.clear();
+        RELEASE(m_BotEngine);
+        m_LoginDeadlines.clear();
 
-        sender->Send(toSend.Serialize().dump());
-        std::cout << INF_CLR << "Game History list sent to " << HASH_CLR(sender) << std::endl << DEF_CLR;
+        for (auto lb : m_Lobbies)
+        {
+            RELEASE(lb);
+        }
+        if (!m_Lobbies.empty())
+            std::cout << INF_CLR << "Deleted " << m_Lobbies.size() << " lobb" << (m_Lobbies.size() > 1 ? "ies" : "y") << "." << std::endl;
+        m_Lobbies.clear();
 
-        break;
+        m_GameServer->Close();
+        delete m_GameServer;
     }
-    case TryToJoinLobby:
+    catch (const TcpIp::TcpIpException& e)
     {
-        Message<TryToJoinLobby> msg(parsedData);
-        bool joined = false;
-
-        // Find the lobby with the given ID
-        for (auto& lb : m_Lobbies)
-        {
-            if (msg.LobbyId != lb->Data.ID) continue;
-            const std::string& playerName = m_Players[sender->GetName()];
-
-            // Check if the player can join it
-            if (lb->IsInLobby(playerName))
-            {
-                std::cout << WRN_CLR << "Player " << HASH_STRING_CLR(playerName) << WRN_CLR << " tried to join lobby: " << INF_CLR << msg.LobbyId << WRN_CLR << " but he's already in." << std::endl << DEF_CLR;
-                joined = false;
-                break;
-            }
-            else if (lb->IsLobbyFull())
-            {
-                std::cout << WRN_CLR << "Player " << HASH_STRING_CLR(playerName) << WRN_CLR << " tried to join lobby: " << INF_CLR << msg.LobbyId << WRN_CLR << " but it's full." << std::endl << DEF_CLR;
-                joined = false;
-                break;
-            }
-
-            lb->AddPlayerToLobby(playerName);
-            joined = true;
-            std::cout << INF_CLR << "[Lobby " << msg.LobbyId << "] Player " << HASH_STRING_CLR(playerName) << INF_CLR << " has joined." << std::endl << DEF_CLR;
-
-            sender->Send(Message<AcceptJoinLobby>().Serialize().dump());
-            std::cout << INF_CLR << "Lobby confirmation sent to " << HASH_CLR(sender) << std::endl << DEF_CLR;
+        std::cout << ERR_CLR << "Game server clean up failed: " << e.what() << std::endl << DEF_CLR;
+    }
+    std::cout << Color::Cyan << "============== Game Server Clean Up Complete ==============" << std::endl << DEF_CLR;
+}
 
-            // Create the lobby game if it doesn't exist
-            if (!m_StartedGames.contains(lb->Data.ID))
-                m_StartedGames.insert({lb->Data.ID, lb});
+#pragma endregion
 
-            RefreshLobbyListToPlayers();
-            break;
-        }
+#pragma region Message Handlers
 
-        // Send rejection message
-        if (!joined)
-        {
-            sender->Send(Message<RejectJoinLobby>().Serialize().dump());
-            std::cout << INF_CLR << "[Lobby " << msg.LobbyId << "] Rejected " << HASH_CLR(sender) << std::endl << DEF_CLR;
-        }
-        break;
+void ServerApp::HandleLogin(Session& session, const Message<MsgType::Login>& msg)
+{
+    if (session.SenderPlayer)
+    {
+        std::cout << WRN_CLR << "Player " << HASH_STRING_CLR(session.SenderPlayer->Name) << WRN_CLR << " tried to login again." << std::endl << DEF_CLR;
+        return;
     }
-    case OnEnterLobby:
+
+    // The name of the bot is reserved, the players could not tell it apart from a human
+    if (msg.Username == BOT_NAME)
     {
-        Message<OnEnterLobby> msg(parsedData);
+        std::cout << WRN_CLR << "Connection from " << HASH_CLR(session.Sender) << WRN_CLR << " tried to login as the bot, kicking it." << std::endl << DEF_CLR;
+        session.Sender->Kick();
+        return;
+    }
 
-        for (auto& lb : m_Lobbies)
-        {
-            if (lb->Data.ID != msg.LobbyId) continue;
+    const ConnectionHandle connection = session.Sender->GetHandle();
+    m_Registry.Register(connection, msg.Username)->Encoding = msg.Encoding;
+    if (const auto it = m_LoginDeadlines.find(connection); it != m_LoginDeadlines.end())
+    {
+        m_Timers.Cancel(it->second);
+        m_LoginDeadlines.erase(it);
+    }
+    std::cout << INF_CLR << "Registered player: " << HASH_STRING_CLR(msg.Username) << INF_CLR << " into server"
+              << (msg.Encoding == MessageEncoding::Binary ? " (binary messages)." : ".") << std::endl << DEF_CLR;
+}
 
-            if (lb->IsLobbyFull())
-            {
-                std::string startingPlayer = rand() % 100 <= 50 ? lb->Data.PlayerX : lb->Data.PlayerO;
+void ServerApp::HandleDisconnect(Session& session, const Message<MsgType::Disconnect>&)
+{
+    if (Lobby* lb = LeaveCurrentLobby(session.SenderPlayer))
+    {
+        OnOpponentLeft(lb);
+        RefreshLobbyListToPlayers();
+    }
+}
 
-                Message<GameStarted> toSend;
-                toSend.GameMode = lb->Data.GameMode;
-                toSend.PlayerO = lb->Data.PlayerO;
-                toSend.PlayerX = lb->Data.PlayerX;
-                toSend.StartPlayer = startingPlayer;
+void ServerApp::HandleFetchLobbyList(Session& session, const Message<MsgType::FetchLobbyList>& msg)
+{
+    // The client knows best which version it has: it may have missed a dropped refresh
+    SendLobbyList(session.Sender, msg.KnownVersion, session.Encoding, SendPolicy::Critical);
+    if (session.SenderPlayer)
+        session.SenderPlayer->LobbyListVersion = m_LobbyList.GetVersion();
+    std::cout << INF_CLR << "Lobby list sent to " << HASH_CLR(session.Sender) << std::endl << DEF_CLR;
+}
 
-                std::string opponentName = lb->GetOpponentName(m_Players[sender->GetName()]);
+void ServerApp::HandleFetchGameHistoryList(Session& session, const Message<MsgType::FetchGameHistoryList>&)
+{
+    if (m_SavedGames.empty())
+        return;
 
-                int i = 0;
-                for (auto& [adressIP, player] : m_Players)
-                {
-                    if (lb->IsInLobby(player))
-                    {
-                        m_GameServer->GetClientByName(adressIP)->Send(toSend.Serialize().dump());
-                        i++;
-                    }
+    Message<MsgType::GameHistoryList> toSend;
+    toSend.GameHistory.reserve(m_SavedGames.size());
+    for (const auto game : m_SavedGames)
+    {
+        toSend.GameHistory.push_back(game);
+    }
 
-                    if (i == 2) break;
-                }
+    SendToClient(session.Sender, toSend, session.Encoding);
+    std::cout << INF_CLR << "Game History list sent to " << HASH_CLR(session.Sender) << std::endl << DEF_CLR;
+}
 
-                std::cout << STS_CLR << "Started game in lobby  " << INF_CLR << lb->Data.ID << std::endl << DEF_CLR;
-            }
+void ServerApp::HandleTryToJoinLobby(Session& session, const Message<MsgType::TryToJoinLobby>& msg)
+{
+    Player* player = session.SenderPlayer;
+    bool joined = false;
 
-            break;
-        }
-        break;
-    }
-    case MakeMove:
+    // Find the lobby with the given ID
+    for (auto& lb : m_Lobbies)
     {
-        Message<MakeMove> msg(parsedData);
-        Lobby* lb = m_StartedGames[msg.LobbyId];
-        std::string& playerName = m_Players[sender->GetName()];
+        if (msg.LobbyId != lb->Data.ID) continue;
+        const std::string& playerName = player->Name;
 
-        // Check if move is valid
-        if (!lb->Board.IsCellEmpty(msg.Cell))
+        // Check if the player can join it
+        if (lb->IsInLobby(playerName) || player->CurrentLobby)
         {
-            std::cout << WRN_CLR << "[Lobby " << msg.LobbyId << "] Player " << HASH_STRING_CLR(playerName) << WRN_CLR << " tried to make an invalid move." << std::endl << DEF_CLR;
-            sender->Send(Message<DeclineMakeMove>().Serialize().dump());
+            std::cout << WRN_CLR << "Player " << HASH_STRING_CLR(playerName) << WRN_CLR << " tried to join lobby: " << INF_CLR << msg.LobbyId << WRN_CLR << " but he's already in." << std::endl << DEF_CLR;
+            joined = false;
             break;
         }
 
-        lb->Board[msg.Cell] = msg.Piece;
-        lb->AddPlayerMove(playerName, msg.Piece, msg.Cell);
-
-        // Send response message to both players
-        Message<AcceptMakeMove> acceptMsg;
-        acceptMsg.Cell = msg.Cell;
-        acceptMsg.Piece = msg.Piece;
+        // The bot only keeps the seat warm until a human takes it
+        if (lb->IsLobbyFull() && lb->BotPiece != TicTacToe::Piece::Empty)
+            UnseatBot(lb);
 
-        int i = 0;
-        for (auto& [adressIP, player] : m_Players)
+        if (lb->IsLobbyFull())
         {
-            if (lb->IsInLobby(player))
-            {
-                m_GameServer->GetClientByName(adressIP)->Send(acceptMsg.Serialize().dump());
-                i++;
-            }
-
-            if (i == 2) break;
-        }
-        std::cout << INF_CLR << "[Lobby " << msg.LobbyId << "] Player " << HASH_STRING_CLR(playerName) << INF_CLR << " made a move." << std::endl << DEF_CLR;
-
-        // Check if the game is over
-        TicTacToe::Piece winner = lb->Board.IsThereAWinner();
-        if (winner != TicTacToe::Piece::Empty)
-        {
-            Message<GameOver> overMsg;
-            overMsg.Winner = winner == TicTacToe::Piece::X ? lb->Data.PlayerX : lb->Data.PlayerO;
-            overMsg.Piece = winner;
-
-            int i = 0;
-            for (auto& [adressIP, player] : m_Players)
-            {
-                if (lb->IsInLobby(player))
-                {
-                    m_GameServer->GetClientByName(adressIP)->Send(overMsg.Serialize().dump());
-                    i++;
-                }
-
-                if (i == 2) break;
-            }
-
-            m_SavedGames.emplace_back(GameData(lb->CurrentGame, lb->Data.PlayerX, lb->Data.PlayerO));
-            lb->ResetGame();
-
-            std::cout << INF_CLR << "[Lobby " << msg.LobbyId << "] Player " << HASH_STRING_CLR(playerName) << INF_CLR << " won the game." << std::endl << DEF_CLR;
+            std::cout << WRN_CLR << "Player " << HASH_STRING_CLR(playerName) << WRN_CLR << " tried to join lobby: " << INF_CLR << msg.LobbyId << WRN_CLR << " but it's full." << std::endl << DEF_CLR;
+            joined = false;
+            break;
         }
-        else if (lb->Board.IsFull())
-        {
-            Message<GameOver> overMsg;
-            overMsg.Winner = "Nobody";
-            overMsg.IsDraw = true;
 
-            int i = 0;
-            for (auto& [adressIP, player] : m_Players)
-            {
-                if (lb->IsInLobby(player))
-                {
-                    m_GameServer->GetClientByName(adressIP)->Send(overMsg.Serialize().dump());
-                    i++;
-                }
+        lb->AddPlayerToLobby(playerName);
+        m_Registry.JoinLobby(player->Id, lb);
+        m_LobbyList.Record(LobbyChange::Joined, lb->Data);
+        joined = true;
+        std::cout << INF_CLR << "[Lobby " << msg.LobbyId << "] Player " << HASH_STRING_CLR(playerName) << INF_CLR << " has joined." << std::endl << DEF_CLR;
 
-                if (i == 2) break;
-            }
+        SendToClient(session.Sender, Message<MsgType::AcceptJoinLobby>(), session.Encoding);
+        std::cout << INF_CLR << "Lobby confirmation sent to " << HASH_CLR(session.Sender) << std::endl << DEF_CLR;
 
-            lb->ResetGame();
+        // Create the lobby game if it doesn't exist
+        if (!m_StartedGames.contains(lb->Data.ID))
+            m_StartedGames.insert({lb->Data.ID, lb});
 
-            std::cout << INF_CLR << "[Lobby " << msg.LobbyId << "] The game ended in a draw." << std::endl << DEF_CLR;
-        }
+        // Nobody to play with, the bot sits in front of the player
+        if (m_BotEngine && !lb->IsLobbyFull())
+            SeatBot(lb);
 
+        RefreshLobbyListToPlayers();
         break;
     }
-    case LeaveLobby:
-    {
-        Message<LeaveLobby> msg(parsedData);
-        Lobby* lb = m_StartedGames[msg.LobbyId];
-        std::string opponentName = lb->GetOpponentName(msg.PlayerName);
-
-        lb->RemovePlayerFromLobby(msg.PlayerName);
-        std::cout << INF_CLR << "[Lobby " << msg.LobbyId << "] Player " << HASH_STRING_CLR(msg.PlayerName) << INF_CLR << " has left." << std::endl << DEF_CLR;
-
-        RefreshLobbyListToPlayers();
 
-        if (m_StartedGames.contains(lb->Data.ID) && lb->IsLobbyEmpty())
-        {
-            m_StartedGames[lb->Data.ID] = nullptr;
-            m_StartedGames.erase(lb->Data.ID);
-            std::cout << INF_CLR << "Closing game " << lb->Data.ID << "..." << std::endl << DEF_CLR;
-        }
+    // Send rejection message
+    if (!joined)
+    {
+        SendToClient(session.Sender, Message<MsgType::RejectJoinLobby>(), session.Encoding);
+        std::cout << INF_CLR << "[Lobby " << msg.LobbyId << "] Rejected " << HASH_CLR(session.Sender) << std::endl << DEF_CLR;
+    }
+}
 
-        if (!lb->IsLobbyEmpty())
-        {
-            for (auto& [adressIP, player] : m_Players)
-            {
-                if (opponentName != player) continue;
+void ServerApp::HandleOnEnterLobby(Session& session, const Message<MsgType::OnEnterLobby>& msg)
+{
+    Lobby* lb = session.SenderPlayer->CurrentLobby;
+    if (!lb || lb->Data.ID != msg.LobbyId)
+    {
+        std::cout << WRN_CLR << "Player " << HASH_STRING_CLR(session.SenderPlayer->Name) << WRN_CLR << " entered lobby: " << INF_CLR << msg.LobbyId << WRN_CLR << " but is not in it." << std::endl << DEF_CLR;
+        return;
+    }
 
-                m_GameServer->GetClientByName(adressIP)->Send(Message<OpponentLeftLobby>().Serialize().dump());
-                break;
-            }
-        }
+    // Both players enter, the game starts once. A running game is never restarted.
+    if (lb->IsLobbyFull() && lb->Turn == TicTacToe::Piece::Empty)
+        StartGame(lb);
+}
 
-        lb->ResetGame();
+void ServerApp::HandleMakeMove(Session& session, const Message<MsgType::MakeMove>& msg)
+{
+    Lobby* lb = session.SenderPlayer->CurrentLobby;
+    const std::string& playerName = session.SenderPlayer->Name;
 
-        break;
+    // Check if move is valid
+    if (!lb || lb->Data.ID != msg.LobbyId || lb->Turn == TicTacToe::Piece::Empty || msg.Piece != lb->Turn || lb->GetPlayerPiece(playerName) != msg.Piece)
+    {
+        std::cout << WRN_CLR << "[Lobby " << msg.LobbyId << "] Player " << HASH_STRING_CLR(playerName) << WRN_CLR << " tried to play out of turn." << std::endl << DEF_CLR;
+        SendToClient(session.Sender, Message<MsgType::DeclineMakeMove>(), session.Encoding);
+        return;
     }
-    default:
-        std::cout << WRN_CLR << "Received JSON from " << HASH_CLR(sender) << WRN_CLR << " contains an unknown type." << std::endl << DEF_CLR;
-        break;
+    if (msg.Cell >= lb->Board.GetTotalSize() || !lb->Board.IsCellEmpty(msg.Cell))
+    {
+        std::cout << WRN_CLR << "[Lobby " << msg.LobbyId << "] Player " << HASH_STRING_CLR(playerName) << WRN_CLR << " tried to make an invalid move." << std::endl << DEF_CLR;
+        SendToClient(session.Sender, Message<MsgType::DeclineMakeMove>(), session.Encoding);
+        return;
     }
 
-    std::cout << std::endl;
+    PlayMove(lb, playerName, msg.Piece, msg.Cell);
 }
 
-void ServerApp::CleanUpGameServer()
+void ServerApp::HandleLeaveLobby(Session& session, const Message<MsgType::LeaveLobby>& msg)
 {
-    std::cout << Color::Cyan << "============== Starting Game Server Clean Up ==============" << std::endl;
-    try
+    Lobby* lb = LeaveCurrentLobby(session.SenderPlayer);
+    if (!lb)
     {
-        for (auto& c : m_GameServer->GetConnections())
-        {
-            c.Kick();
-        }
-
-        int count = 0;
-        m_GameServer->CleanClosedConnections([&](ClientPtr c) { ++count; });
-        if (count > 0)
-            std::cout << INF_CLR << "Closed " << count << " connection" << (count > 1 ? "s" : "") << "." << std::endl;
-
-        for (auto& [id, lobby] : m_StartedGames)
-        {
-            NULLPTR(lobby);
-        }
-        if (!m_StartedGames.empty())
-            std::cout << INF_CLR << "Ended " << m_StartedGames.size() << " started game" << (m_StartedGames.size() > 1 ? "s" : "") << "." << std::endl;
-        m_StartedGames.clear();
-
-        for (auto lb : m_Lobbies)
-        {
-            RELEASE(lb);
-        }
-        if (!m_Lobbies.empty())
-            std::cout << INF_CLR << "Deleted " << m_Lobbies.size() << " lobb" << (m_Lobbies.size() > 1 ? "ies" : "y") << "." << std::endl;
-        m_Lobbies.clear();
-
-        m_GameServer->Close();
-        delete m_GameServer;
-    }
-    catch (const TcpIp::TcpIpException& e)
-    {
-        std::cout << ERR_CLR << "Game server clean up failed: " << e.what() << std::endl << DEF_CLR;
+        std::cout << WRN_CLR << "Player " << HASH_STRING_CLR(session.SenderPlayer->Name) << WRN_CLR << " tried to leave lobby: " << INF_CLR << msg.LobbyId << WRN_CLR << " but is not in one." << std::endl << DEF_CLR;
+        return;
     }
-    std::cout << Color::Cyan << "============== Game Server Clean Up Complete ==============" << std::endl << DEF_CLR;
+
+    OnOpponentLeft(lb);
+    RefreshLobbyListToPlayers();
 }
 
 #pragma endregion
@@ -521,7 +639,7 @@ bool ServerApp::InitWebServer()
     std::cout << WEB_PFX << Color::Cyan << "===== Starting Web Server Initialization  ===========" << std::endl << DEF_CLR;
     try
     {
-        m_WebServer = new HtmlServer();
+        m_WebServer = new HtmlServer(m_LoopBackend);
         m_WebServer->Open(DEFAULT_PORT + 1);
         std::cout << WEB_PFX << "Web server is listening on port " << DEFAULT_PORT + 1 << "..." << std::endl;
     }
@@ -539,7 +657,7 @@ void ServerApp::HandleWebServer()
 {
     try
     {
-        m_WebServer->CheckNetwork();
+        m_WebServer->CheckNetwork(m_ReadyEvents);
 
         WebClientPtr newClient;
         while ((newClient = m_WebServer->FindNewClient()) != nullptr)
@@ -743,16 +861,6 @@ void ServerApp::CleanUpWebServer()
 
 #pragma region Lobbying
 
-bool ServerApp::IsPlayerInLobby(const std::string& name) const
-{
-    for (const auto lobby : m_Lobbies)
-    {
-        if (lobby->IsInLobby(name))
-            return true;
-    }
-    return false;
-}
-
 void ServerApp::CreateLobbies()
 {
     for (int i = 0; i < MAXIMUM_LOBBIES; i++)
@@ -768,4 +876,209 @@ void ServerApp::CreateLobbies()
     }
 }
 
-#pragma endregion
\ No newline at end of file
+Lobby* ServerApp::LeaveCurrentLobby(Player* player)
+{
+    Lobby* lb = player->CurrentLobby;
+    if (!lb)
+        return nullptr;
+
+    lb->RemovePlayerFromLobby(player->Name);
+    m_Registry.LeaveLobby(player->Id);
+    m_LobbyList.Record(LobbyChange::Left, lb->Data);
+    StopTurnClock(lb);
+    // The game stops, the next one starts when the lobby is full again
+    lb->Turn = TicTacToe::Piece::Empty;
+    std::cout << INF_CLR << "[Lobby " << lb->Data.ID << "] Player " << HASH_STRING_CLR(player->Name) << INF_CLR << " has left." << std::endl << DEF_CLR;
+
+    // The bot only plays against humans
+    if (lb->BotPiece != TicTacToe::Piece::Empty)
+        UnseatBot(lb);
+
+    if (m_StartedGames.contains(lb->Data.ID) && lb->IsLobbyEmpty())
+    {
+        m_StartedGames[lb->Data.ID] = nullptr;
+        m_StartedGames.erase(lb->Data.ID);
+        std::cout << INF_CLR << "Closing game " << lb->Data.ID << "..." << std::endl << DEF_CLR;
+    }
+    return lb;
+}
+
+void ServerApp::OnOpponentLeft(Lobby* lb)
+{
+    // Only the opponent is left in it
+    SendToLobby(lb, Message<MsgType::OpponentLeftLobby>());
+
+    lb->ResetGame();
+
+    // The bot takes the seat, the opponent plays on
+    if (m_BotEngine && lb->PlayerCount == 1)
+    {
+        SeatBot(lb);
+        if (lb->IsLobbyFull())
+            StartGame(lb);
+    }
+}
+
+#pragma endregion
+
+#pragma region Game
+
+void ServerApp::StartGame(Lobby* lb)
+{
+    std::string startingPlayer = rand() % 100 <= 50 ? lb->Data.PlayerX : lb->Data.PlayerO;
+
+    Message<MsgType::GameStarted> toSend;
+    toSend.GameMode = lb->Data.GameMode;
+    toSend.PlayerO = lb->Data.PlayerO;
+    toSend.PlayerX = lb->Data.PlayerX;
+    toSend.StartPlayer = startingPlayer;
+    // The clients clear their board, a new game starts
+    lb->ResetGame();
+    lb->Turn = startingPlayer == lb->Data.PlayerX ? TicTacToe::Piece::X : TicTacToe::Piece::O;
+
+    SendToLobby(lb, toSend);
+
+    std::cout << STS_CLR << "Started game in lobby  " << INF_CLR << lb->Data.ID << std::endl << DEF_CLR;
+    StartTurnClock(lb);
+    ScheduleBotMove(lb);
+}
+
+void ServerApp::PlayMove(Lobby* lb, const std::string& playerName, TicTacToe::Piece piece, unsigned int cell)
+{
+    lb->Board[cell] = piece;
+    lb->AddPlayerMove(playerName, piece, cell);
+
+    // Send response message to both players
+    Message<MsgType::AcceptMakeMove> acceptMsg;
+    acceptMsg.Cell = cell;
+    acceptMsg.Piece = piece;
+
+    SendToLobby(lb, acceptMsg);
+    std::cout << INF_CLR << "[Lobby " << lb->Data.ID << "] Player " << HASH_STRING_CLR(playerName) << INF_CLR << " made a move." << std::endl << DEF_CLR;
+
+    // The clients switch turns on every accepted move, the last one of a game included
+    lb->Turn = piece == TicTacToe::Piece::X ? TicTacToe::Piece::O : TicTacToe::Piece::X;
+
+    // Check if the game is over, only the lines through the new piece can have changed
+    TicTacToe::Piece winner = lb->Board.CheckWinAt(cell);
+    if (winner != TicTacToe::Piece::Empty)
+    {
+        Message<MsgType::GameOver> overMsg;
+        overMsg.Winner = winner == TicTacToe::Piece::X ? lb->Data.PlayerX : lb->Data.PlayerO;
+        overMsg.Piece = winner;
+
+        SendToLobby(lb, overMsg);
+
+        m_SavedGames.emplace_back(GameData(lb->CurrentGame, lb->Data.PlayerX, lb->Data.PlayerO));
+        lb->ResetGame();
+
+        std::cout << INF_CLR << "[Lobby " << lb->Data.ID << "] Player " << HASH_STRING_CLR(playerName) << INF_CLR << " won the game." << std::endl << DEF_CLR;
+    }
+    else if (lb->Board.IsFull())
+    {
+        Message<MsgType::GameOver> overMsg;
+        overMsg.Winner = "Nobody";
+        overMsg.IsDraw = true;
+
+        SendToLobby(lb, overMsg);
+
+        lb->ResetGame();
+
+        std::cout << INF_CLR << "[Lobby " << lb->Data.ID << "] The game ended in a draw." << std::endl << DEF_CLR;
+    }
+
+    // The next game goes on in the same lobby
+    StartTurnClock(lb);
+    ScheduleBotMove(lb);
+}
+
+void ServerApp::StartTurnClock(Lobby* lb)
+{
+    if (lb->Data.GameMode != FAST)
+        return;
+
+    StopTurnClock(lb);
+    const auto turnTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<float>(GAMEMODE_FAST.PlayerMoveLimitTime));
+    m_TurnTimers[lb->Data.ID] = m_Timers.Schedule(turnTime + TURN_GRACE_TIME, [this, lb]() { OnTurnTimeout(lb); });
+}
+
+void ServerApp::StopTurnClock(Lobby* lb)
+{
+    auto it = m_TurnTimers.find(lb->Data.ID);
+    if (it == m_TurnTimers.end())
+        return;
+
+    m_Timers.Cancel(it->second);
+    m_TurnTimers.erase(it);
+}
+
+void ServerApp::OnTurnTimeout(Lobby* lb)
+{
+    m_TurnTimers.erase(lb->Data.ID);
+    if (!lb->IsLobbyFull() || lb->Turn == TicTacToe::Piece::Empty)
+        return;
+
+    const std::string playerName = lb->Turn == TicTacToe::Piece::X ? lb->Data.PlayerX : lb->Data.PlayerO;
+    std::cout << WRN_CLR << "[Lobby " << lb->Data.ID << "] Player " << HASH_STRING_CLR(playerName) << WRN_CLR << " ran out of time." << std::endl << DEF_CLR;
+
+    PlayMove(lb, playerName, lb->Turn, lb->Board.GetRandomEmptyCell());
+    std::cout << std::endl;
+}
+
+#pragma endregion
+
+#pragma region Bot
+
+void ServerApp::SeatBot(Lobby* lb)
+{
+    lb->AddPlayerToLobby(BOT_NAME);
+    lb->BotPiece = lb->GetPlayerPiece(BOT_NAME);
+    m_LobbyList.Record(LobbyChange::Joined, lb->Data);
+    std::cout << INF_CLR << "[Lobby " << lb->Data.ID << "] The bot has joined." << std::endl << DEF_CLR;
+}
+
+void ServerApp::UnseatBot(Lobby* lb)
+{
+    if (const auto it = m_BotMoveTimers.find(lb->Data.ID); it != m_BotMoveTimers.end())
+    {
+        m_Timers.Cancel(it->second);
+        m_BotMoveTimers.erase(it);
+    }
+
+    lb->RemovePlayerFromLobby(BOT_NAME);
+    lb->BotPiece = TicTacToe::Piece::Empty;
+    m_LobbyList.Record(LobbyChange::Left, lb->Data);
+    StopTurnClock(lb);
+    lb->Turn = TicTacToe::Piece::Empty;
+    std::cout << INF_CLR << "[Lobby " << lb->Data.ID << "] The bot has left." << std::endl << DEF_CLR;
+
+    // Like an opponent leaving: the player left waits for another one
+    SendToLobby(lb, Message<MsgType::OpponentLeftLobby>());
+    lb->ResetGame();
+}
+
+void ServerApp::ScheduleBotMove(Lobby* lb)
+{
+    if (!m_BotEngine || lb->BotPiece == TicTacToe::Piece::Empty || lb->Turn != lb->BotPiece || m_BotMoveTimers.contains(lb->Data.ID))
+        return;
+
+    m_BotMoveTimers[lb->Data.ID] = m_Timers.Schedule(BOT_MOVE_DELAY, [this, lb]() { PlayBotMove(lb); });
+}
+
+void ServerApp::PlayBotMove(Lobby* lb)
+{
+    m_BotMoveTimers.erase(lb->Data.ID);
+    if (lb->BotPiece == TicTacToe::Piece::Empty || lb->Turn != lb->BotPiece)
+        return;
+
+    const auto start = std::chrono::steady_clock::now();
+    const TicTacToe::SearchEngine::Result result = m_BotEngine->FindBestMove(lb->Board, lb->BotPiece, m_BotThinkTime);
+    const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << INF_CLR << "[Lobby " << lb->Data.ID << "] The bot searched " << result.Depth << " plies (" << result.Nodes << " nodes) in "
+        << std::fixed << std::setprecision(1) << milliseconds << " ms" << (result.IsSolved ? ", solved." : ".") << std::endl << DEF_CLR;
+
+    PlayMove(lb, BOT_NAME, lb->BotPiece, result.Cell);
+    std::cout << std::endl;
+}
+
+#pragma endregion
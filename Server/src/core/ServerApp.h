@@ -2,7 +2,14 @@
 #include "src/tcp-ip/TcpIpServer.h"
 #include <src/tcp-ip/HtmlServer.h>
 #include "game/Lobby.h"
+#include "LatencyReport.h"
+#include "TimerWheel.h"
+#include "PlayerRegistry.h"
+#include "MessageHandlers.h"
+#include "LobbyListCache.h"
 #include <game/GameData.h>
+#include <game/SearchEngine.h>
+#include <tcp-ip/MessageCodec.h>
 
 class ServerApp
 {
@@ -12,18 +19,82 @@ public:
     ServerApp(const ServerApp&) = delete;
     ServerApp& operator=(const ServerApp&) = delete;
 
+    /// <summary>
+    /// Measure the time between an I/O thread posting messages and their handling, and print it on clean up.
+    /// </summary>
+    void EnableLatencyReport();
+    /// <summary>
+    /// Set how long lobby list changes are gathered before being sent to the players. 0 or less sends every change right away.
+    /// </summary>
+    void SetLobbyRefreshWindow(std::chrono::milliseconds window) { m_LobbyRefreshWindow = window; }
+    /// <summary>
+    /// Seat a bot against the players waiting alone in a lobby, thinking up to `thinkTime` per move.
+    /// The bot thinks on the game thread, the whole server waits for it meanwhile.
+    /// It gives its seat up to the next human who joins.
+    /// </summary>
+    void EnableBot(std::chrono::milliseconds thinkTime);
+
     void Init();
     void Run();
     void CleanUp();
 
+private: // Main loop
+    /// <summary>
+    /// How long the main loop can sleep before something has to be done, in milliseconds. -1 means until an event.
+    /// </summary>
+    int GetWaitTimeout() const;
+
+    // Every event of the main thread wakes it up through this backend: web sockets, game server events and shutdown
+    IReadinessBackend* m_LoopBackend = nullptr;
+    std::vector<ReadyEvent> m_ReadyEvents;
+    // Deadlines of the server: turn clocks, login timeouts
+    TimerWheel m_Timers;
+    LatencyReport* m_LatencyReport = nullptr;
+
 private: // Game Server
     bool InitGameServer();
     void HandleGameServer();
-    void UnregisterPlayerFromServer(const std::string& player);
-    void HandleRecv(ClientPtr sender);
+    void UnregisterPlayerFromServer(PlayerId id);
+    /// <summary>
+    /// Read the type of a message, and call its handler.
+    /// </summary>
+    void HandleRecv(ClientPtr sender, const TcpIp::Frame& frame);
+    void PrintHandlerTimings(std::ostream& os) const;
     void CleanUpGameServer();
 
     TcpIpServer* m_GameServer = nullptr;
+    // HashMap <Connection, Timer kicking the connection if it does not log in>
+    std::unordered_map<ConnectionHandle, TimerWheel::TimerId> m_LoginDeadlines;
+    // Only measured with the latency report
+    std::array<HandlerTiming, MSG_TYPE_COUNT> m_HandlerTimings{};
+
+private: // Message handlers
+    /// <summary>
+    /// Who sent the message being handled.
+    /// </summary>
+    struct Session
+    {
+        ClientPtr Sender = nullptr;
+        // nullptr until the connection logs in
+        Player* SenderPlayer = nullptr;
+        // Replies use the encoding chosen at login, or the one of the request before that
+        MessageEncoding Encoding = MessageEncoding::Json;
+    };
+    typedef MessageHandlers<ServerApp, Session> Handlers;
+
+    /// <summary>
+    /// The handler of each message type, built at compile time.
+    /// </summary>
+    static const Handlers& GetHandlers();
+
+    void HandleLogin(Session& session, const Message<MsgType::Login>& msg);
+    void HandleDisconnect(Session& session, const Message<MsgType::Disconnect>& msg);
+    void HandleFetchLobbyList(Session& session, const Message<MsgType::FetchLobbyList>& msg);
+    void HandleFetchGameHistoryList(Session& session, const Message<MsgType::FetchGameHistoryList>& msg);
+    void HandleTryToJoinLobby(Session& session, const Message<MsgType::TryToJoinLobby>& msg);
+    void HandleOnEnterLobby(Session& session, const Message<MsgType::OnEnterLobby>& msg);
+    void HandleMakeMove(Session& session, const Message<MsgType::MakeMove>& msg);
+    void HandleLeaveLobby(Session& session, const Message<MsgType::LeaveLobby>& msg);
 
 private: // Web Server
     bool InitWebServer();
@@ -36,16 +107,117 @@ private: // Web Server
 
 private: // Lobbies
     void CreateLobbies();
-    bool IsPlayerInLobby(const std::string& name) const;
-    const std::string& SerializeAllLobbies() const;
+    /// <summary>
+    /// Take a player out of its lobby, and close the game if nobody is left.
+    /// </summary>
+    /// <returns>The lobby the player left, or nullptr if it was in none.</returns>
+    Lobby* LeaveCurrentLobby(Player* player);
+    /// <summary>
+    /// Tell the player left in a lobby that its opponent is gone, and seat the bot in front of them if it is enabled.
+    /// Called however the opponent left: the lobby, the server, or a closed connection.
+    /// </summary>
+    void OnOpponentLeft(Lobby* lobby);
+    /// <summary>
+    /// Send a message to one client, with its type in the frame header.
+    /// </summary>
+    template <MsgType T>
+    void SendToClient(ClientPtr client, const Message<T>& message, MessageEncoding encoding);
+    /// <summary>
+    /// Send a message to the subscribers of a lobby (its players and spectators), in the encoding of each.
+    /// </summary>
+    template <MsgType T>
+    void SendToLobby(const Lobby* lobby, const Message<T>& message);
+    /// <summary>
+    /// Send the changes of the lobby list since a version, or the whole list if they are no longer known.
+    /// </summary>
+    void SendLobbyList(ClientPtr client, unsigned int knownVersion, MessageEncoding encoding, SendPolicy policy);
+    /// <summary>
+    /// Send the lobby list changes to the players that are not in a lobby. At most one broadcast per refresh window:
+    /// the first change is sent right away, the ones made during the window are sent together at its end.
+    /// </summary>
     void RefreshLobbyListToPlayers();
+    void BroadcastLobbyList();
+    void OnLobbyRefreshWindowEnd();
+    void PrintLobbyRefreshStats(std::ostream& os) const;
 
-    // HashMap <Address (connection name), Username>
-    std::unordered_map<std::string, std::string> m_Players;
+    PlayerRegistry m_Registry;
     std::vector<Lobby*> m_Lobbies;
+    // Records every change of the data of a lobby (a player joins or leaves)
+    LobbyListCache m_LobbyList{m_Lobbies};
+    std::chrono::milliseconds m_LobbyRefreshWindow{50};
+    // Running during a refresh window, refreshes asked meanwhile wait for its end
+    TimerWheel::TimerId m_LobbyRefreshTimer = TimerWheel::INVALID_TIMER;
+    bool m_IsLobbyRefreshPending = false;
+    struct LobbyRefreshStats
+    {
+        size_t Requests = 0;
+        size_t Broadcasts = 0;
+        // Requests folded into a later broadcast
+        size_t Suppressed = 0;
+        size_t Messages = 0;
+        // Players skipped while congested, they get the changes with a later broadcast
+        size_t Deferred = 0;
+    } m_LobbyRefreshStats;
     std::vector<GameData> m_SavedGames;
 
 private: //Game
+    /// <summary>
+    /// Start a game in a full lobby, with a random starting player.
+    /// </summary>
+    void StartGame(Lobby* lobby);
+    /// <summary>
+    /// Place a validated move, tell both players, end the game if it is over, and pass the turn.
+    /// </summary>
+    void PlayMove(Lobby* lobby, const std::string& playerName, TicTacToe::Piece piece, unsigned int cell);
+    /// <summary>
+    /// (Re)start the clock of the player whose turn it is. Only FAST games have one.
+    /// </summary>
+    void StartTurnClock(Lobby* lobby);
+    void StopTurnClock(Lobby* lobby);
+    /// <summary>
+    /// The player took too long: play a random move for them, like the client does.
+    /// </summary>
+    void OnTurnTimeout(Lobby* lobby);
 
     std::unordered_map<unsigned int, Lobby*> m_StartedGames;
+    // HashMap <Lobby ID, Timer of the current turn>
+    std::unordered_map<unsigned int, TimerWheel::TimerId> m_TurnTimers;
+
+private: // Bot
+    /// <summary>
+    /// Take the free seat of a lobby with the bot, like a player joining.
+    /// </summary>
+    void SeatBot(Lobby* lobby);
+    /// <summary>
+    /// Take the bot out of a lobby, like a player leaving: the game is reset and the opponent told.
+    /// </summary>
+    void UnseatBot(Lobby* lobby);
+    /// <summary>
+    /// Play the move of the bot after a short delay, if it has to play next.
+    /// </summary>
+    void ScheduleBotMove(Lobby* lobby);
+    void PlayBotMove(Lobby* lobby);
+
+    // nullptr unless the bot is enabled. One engine for every lobby, it only searches on the main thread
+    TicTacToe::SearchEngine* m_BotEngine = nullptr;
+    std::chrono::milliseconds m_BotThinkTime{0};
+    // HashMap <Lobby ID, Timer of the next bot move>
+    std::unordered_map<unsigned int, TimerWheel::TimerId> m_BotMoveTimers;
 };
+
+template <MsgType T>
+void ServerApp::SendToClient(ClientPtr client, const Message<T>& message, MessageEncoding encoding)
+{
+    client->Send(std::make_shared<const std::string>(EncodeFrame(message, encoding)));
+}
+
+template <MsgType T>
+void ServerApp::SendToLobby(const Lobby* lobby, const Message<T>& message)
+{
+    BroadcastMessage<T> encoded(message);
+    for (const LobbySubscriber& subscriber : lobby->Subscribers)
+    {
+        if (const ClientPtr client = m_GameServer->GetClient(subscriber.Connection))
+            client->Send(encoded.Get(subscriber.Encoding));
+    }
+}
@@ -0,0 +1,82 @@
+#include "ShutdownSignal.h"
+#include "ConsoleHelper.h"
+#include <atomic>
+#include <thread>
+#ifndef _WIN32
+#include <csignal>
+#endif
+
+namespace ShutdownSignal
+{
+    static std::atomic<bool> s_Requested = false;
+    static std::atomic<IReadinessBackend*> s_WakeTarget = nullptr;
+    // Requests using the wake target right now, Uninstall() waits for them before it can be deleted
+    static std::atomic<int> s_ActiveWakes = 0;
+
+#ifdef _WIN32
+    // Called on its own thread for Ctrl+C, Ctrl+Break and closing the console
+    static BOOL WINAPI OnConsoleControl(DWORD)
+    {
+        Request();
+        return TRUE;
+    }
+#else
+    // Only atomics and a write() to an eventfd are used, which is safe in a signal handler
+    static void OnSignal(int)
+    {
+        Request();
+    }
+#endif
+
+    void Install(IReadinessBackend* wakeTarget)
+    {
+        s_WakeTarget = wakeTarget;
+
+#ifdef _WIN32
+        SetConsoleCtrlHandler(OnConsoleControl, TRUE);
+#else
+        std::signal(SIGINT, OnSignal);
+        std::signal(SIGTERM, OnSignal);
+#endif
+
+        // Waiting for a key blocks, so it gets its own thread. It is never joined: it may still be waiting when the app exits.
+        std::thread([]()
+            {
+                if (WaitForKey(27)) // 27 = ESC
+                    Request();
+            }).detach();
+    }
+
+    void Uninstall()
+    {
+        s_WakeTarget = nullptr;
+        while (s_ActiveWakes > 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void Request()
+    {
+        s_Requested = true;
+
+        ++s_ActiveWakes;
+        if (IReadinessBackend* wakeTarget = s_WakeTarget)
+        {
+            try
+            {
+                wakeTarget->Wake();
+            }
+            catch (...)
+            {
+                // The request is recorded, the main loop sees it on its next wake up
+            }
+        }
+        --s_ActiveWakes;
+    }
+
+    bool IsRequested()
+    {
+        return s_Requested;
+    }
+}
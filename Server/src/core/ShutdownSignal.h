@@ -0,0 +1,26 @@
+#pragma once
+#include "src/tcp-ip/ReadinessBackend.h"
+
+/// <summary>
+/// Lets the user stop the server with ESC, Ctrl+C or a termination request, and wakes up the main loop when it happens.
+/// </summary>
+namespace ShutdownSignal
+{
+    /// <summary>
+    /// Start listening for the shutdown requests.
+    /// </summary>
+    /// <param name="wakeTarget">The backend the main loop waits on.</param>
+    void Install(IReadinessBackend* wakeTarget);
+    /// <summary>
+    /// Stop waking up the main loop, before its backend is deleted. The requests are still recorded.
+    /// </summary>
+    void Uninstall();
+    /// <summary>
+    /// Request the shutdown. (Thread safe, never throws: it is called from the signal handlers)
+    /// </summary>
+    void Request();
+    /// <summary>
+    /// True once a shutdown was requested.
+    /// </summary>
+    bool IsRequested();
+}
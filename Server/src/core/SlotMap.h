@@ -0,0 +1,149 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Identifies a value of a SlotMap: slot index in the low 32 bits, slot generation in the high 32 bits.
+/// Once the value is erased the handle stays invalid, even when the slot is reused.
+/// </summary>
+typedef uint64_t SlotHandle;
+constexpr SlotHandle INVALID_SLOT_HANDLE = 0;
+
+/// <summary>
+/// Container giving stable handles to its values.
+/// Values are stored contiguously and iterated in no particular order, erasing moves the last value into the hole.
+/// Pointers to values are only valid until the next Emplace or Erase, keep handles instead.
+/// </summary>
+template<typename T>
+class SlotMap final
+{
+public:
+    using Iterator = typename std::vector<T>::iterator;
+    using ConstIterator = typename std::vector<T>::const_iterator;
+
+    template<typename... Args>
+    SlotHandle Emplace(Args&&... args)
+    {
+        uint32_t slotIndex;
+        if (m_FreeSlot != NONE)
+        {
+            slotIndex = m_FreeSlot;
+            m_FreeSlot = m_Slots[slotIndex].Index;
+        }
+        else
+        {
+            slotIndex = static_cast<uint32_t>(m_Slots.size());
+            m_Slots.emplace_back();
+        }
+
+        m_Values.emplace_back(std::forward<Args>(args)...);
+        m_ValueSlots.push_back(slotIndex);
+
+        Slot& slot = m_Slots[slotIndex];
+        slot.Index = static_cast<uint32_t>(m_Values.size() - 1);
+        return MakeHandle(slotIndex, slot.Generation);
+    }
+
+    /// <summary>
+    /// Remove a value. The last value takes its place.
+    /// </summary>
+    /// <returns>False if the handle was already invalid.</returns>
+    bool Erase(SlotHandle handle)
+    {
+        const uint32_t slotIndex = static_cast<uint32_t>(handle);
+        if (!Contains(handle))
+            return false;
+
+        Slot& slot = m_Slots[slotIndex];
+        const uint32_t valueIndex = slot.Index;
+        const uint32_t lastIndex = static_cast<uint32_t>(m_Values.size() - 1);
+        if (valueIndex != lastIndex)
+        {
+            m_Values[valueIndex] = std::move(m_Values[lastIndex]);
+            m_ValueSlots[valueIndex] = m_ValueSlots[lastIndex];
+            m_Slots[m_ValueSlots[valueIndex]].Index = valueIndex;
+        }
+        m_Values.pop_back();
+        m_ValueSlots.pop_back();
+
+        // Old handles of this slot are now stale. Generation 0 is skipped so no handle is ever INVALID_SLOT_HANDLE.
+        if (++slot.Generation == 0)
+            slot.Generation = 1;
+        slot.Index = m_FreeSlot;
+        m_FreeSlot = slotIndex;
+        return true;
+    }
+
+    bool Contains(SlotHandle handle) const
+    {
+        const uint32_t slotIndex = static_cast<uint32_t>(handle);
+        return slotIndex < m_Slots.size()
+            && m_Slots[slotIndex].Generation == static_cast<uint32_t>(handle >> 32)
+            && m_Slots[slotIndex].Index < m_Values.size()
+            && m_ValueSlots[m_Slots[slotIndex].Index] == slotIndex;
+    }
+
+    /// <summary>
+    /// Return the value of a handle, or nullptr if it was erased.
+    /// </summary>
+    T* Get(SlotHandle handle) { return Contains(handle) ? &m_Values[m_Slots[static_cast<uint32_t>(handle)].Index] : nullptr; }
+    const T* Get(SlotHandle handle) const { return Contains(handle) ? &m_Values[m_Slots[static_cast<uint32_t>(handle)].Index] : nullptr; }
+
+    /// <summary>
+    /// Return the handle of the value at a position of the contiguous storage.
+    /// </summary>
+    SlotHandle GetHandleAt(size_t position) const
+    {
+        const uint32_t slotIndex = m_ValueSlots[position];
+        return MakeHandle(slotIndex, m_Slots[slotIndex].Generation);
+    }
+
+    T& operator[](size_t position) { return m_Values[position]; }
+    const T& operator[](size_t position) const { return m_Values[position]; }
+
+    size_t Size() const { return m_Values.size(); }
+    bool IsEmpty() const { return m_Values.empty(); }
+
+    void Clear()
+    {
+        // Every slot goes back to the free list with a new generation
+        for (size_t position = 0; position < m_ValueSlots.size(); ++position)
+        {
+            Slot& slot = m_Slots[m_ValueSlots[position]];
+            if (++slot.Generation == 0)
+                slot.Generation = 1;
+            slot.Index = m_FreeSlot;
+            m_FreeSlot = m_ValueSlots[position];
+        }
+        m_Values.clear();
+        m_ValueSlots.clear();
+    }
+
+    Iterator begin() { return m_Values.begin(); }
+    Iterator end() { return m_Values.end(); }
+    ConstIterator begin() const { return m_Values.begin(); }
+    ConstIterator end() const { return m_Values.end(); }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Slot
+    {
+        uint32_t Generation = 1;
+        // Position of the value in m_Values, or the next free slot while the slot is free
+        uint32_t Index = NONE;
+    };
+
+    static SlotHandle MakeHandle(uint32_t slotIndex, uint32_t generation)
+    {
+        return static_cast<SlotHandle>(generation) << 32 | slotIndex;
+    }
+
+    std::vector<T> m_Values;
+    // Slot of each value, to fix the slot of the value moved by Erase
+    std::vector<uint32_t> m_ValueSlots;
+    std::vector<Slot> m_Slots;
+    uint32_t m_FreeSlot = NONE;
+};
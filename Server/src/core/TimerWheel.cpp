@@ -0,0 +1,256 @@
+#include "TimerWheel.h"
+#include <bit>
+
+// Index of the first set bit of `bits` at or after `from`, wrapping around. `bits` must not be 0.
+static unsigned int NextSetBit(uint64_t bits, unsigned int from)
+{
+    const uint64_t rotated = std::rotr(bits, static_cast<int>(from));
+    return (from + std::countr_zero(rotated)) & 63;
+}
+
+TimerWheel::TimerWheel(Clock::duration tick)
+    : m_Tick(tick)
+    , m_Start(Clock::now())
+{
+    for (uint32_t& slot : m_Slots)
+    {
+        slot = NONE;
+    }
+}
+
+uint64_t TimerWheel::ToTick(Clock::time_point time) const
+{
+    if (time <= m_Start)
+        return 0;
+    return static_cast<uint64_t>((time - m_Start) / m_Tick);
+}
+
+TimerWheel::TimerId TimerWheel::Schedule(Clock::duration delay, Callback callback)
+{
+    uint32_t index;
+    if (!m_FreeNodes.empty())
+    {
+        index = m_FreeNodes.back();
+        m_FreeNodes.pop_back();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_Nodes.size());
+        m_Nodes.emplace_back();
+    }
+
+    // Round the deadline up, a timer never fires early. At least one tick, so a callback that reschedules itself can't loop forever.
+    const uint64_t expireTick = ToTick(Clock::now() + delay + m_Tick - Clock::duration(1));
+
+    Node& node = m_Nodes[index];
+    node.ExpireTick = expireTick > m_CurrentTick ? expireTick : m_CurrentTick + 1;
+    node.Function = std::move(callback);
+    Insert(index);
+    ++m_Count;
+
+    return static_cast<TimerId>(node.Generation) << 32 | index;
+}
+
+bool TimerWheel::Cancel(TimerId id)
+{
+    if (!IsScheduled(id))
+        return false;
+
+    const uint32_t index = static_cast<uint32_t>(id);
+    Unlink(index);
+    Release(index);
+    return true;
+}
+
+bool TimerWheel::IsScheduled(TimerId id) const
+{
+    const uint32_t index = static_cast<uint32_t>(id);
+    if (index >= m_Nodes.size())
+        return false;
+
+    const Node& node = m_Nodes[index];
+    return node.Slot != NONE && node.Generation == static_cast<uint32_t>(id >> 32);
+}
+
+size_t TimerWheel::Advance(Clock::time_point now)
+{
+    const uint64_t target = ToTick(now);
+    size_t fired = 0;
+    if (m_Count == 0)
+    {
+        // Nothing to run or cascade on the way
+        if (target > m_CurrentTick)
+            m_CurrentTick = target;
+        return fired;
+    }
+
+    while (m_CurrentTick < target)
+    {
+        // Jump to the next level 0 slot with timers, or to the end of the level 0 round if there is none
+        const unsigned int position = static_cast<unsigned int>(m_CurrentTick & (SLOTS - 1));
+        const uint64_t ahead = position == SLOTS - 1 ? 0 : m_Occupied[0] & (~0ull << (position + 1));
+        const uint64_t next = ahead != 0
+            ? (m_CurrentTick & ~static_cast<uint64_t>(SLOTS - 1)) + std::countr_zero(ahead)
+            : (m_CurrentTick | (SLOTS - 1)) + 1;
+
+        if (next > target)
+        {
+            m_CurrentTick = target;
+            break;
+        }
+        m_CurrentTick = next;
+
+        // A new level 0 round: bring down the timers of the higher levels that are due in it
+        if ((m_CurrentTick & (SLOTS - 1)) == 0)
+        {
+            unsigned int level = 1;
+            while (level < LEVELS - 1 && ((m_CurrentTick >> (SLOT_BITS * level)) & (SLOTS - 1)) == 0)
+            {
+                ++level;
+            }
+            for (; level >= 1; --level)
+            {
+                Cascade(level);
+            }
+        }
+
+        fired += RunSlot();
+    }
+    return fired;
+}
+
+int TimerWheel::GetTimeoutMs(Clock::time_point now) const
+{
+    if (m_Count == 0)
+        return -1;
+
+    // The first tick at which Advance has something to do, on any level
+    uint64_t nextTick = UINT64_MAX;
+    for (unsigned int level = 0; level < LEVELS; ++level)
+    {
+        if (m_Occupied[level] == 0)
+            continue;
+
+        const unsigned int shift = SLOT_BITS * level;
+        const uint64_t levelTick = m_CurrentTick >> shift;
+        const unsigned int position = static_cast<unsigned int>(levelTick & (SLOTS - 1));
+
+        // The slot of the current position was already handled, it is only due again one round later
+        const unsigned int slot = NextSetBit(m_Occupied[level], (position + 1) & (SLOTS - 1));
+        const uint64_t distance = slot > position ? slot - position : slot + SLOTS - position;
+        const uint64_t tick = (levelTick + distance) << shift;
+        if (tick < nextTick)
+            nextTick = tick;
+    }
+
+    const Clock::time_point deadline = m_Start + m_Tick * nextTick;
+    if (deadline <= now)
+        return 0;
+
+    // Round up, waking up before the tick would find nothing to do
+    const auto milliseconds = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+    return milliseconds > INT32_MAX ? INT32_MAX : static_cast<int>(milliseconds);
+}
+
+void TimerWheel::Insert(uint32_t index)
+{
+    Node& node = m_Nodes[index];
+    const uint64_t delta = node.ExpireTick - m_CurrentTick;
+
+    // The lowest level whose range covers the delay. Timers beyond the last level wait in its farthest slot.
+    unsigned int level = 0;
+    while (level < LEVELS - 1 && delta >= (1ull << (SLOT_BITS * (level + 1))))
+    {
+        ++level;
+    }
+
+    uint64_t placement = node.ExpireTick;
+    const uint64_t range = 1ull << (SLOT_BITS * LEVELS);
+    if (delta >= range)
+        placement = m_CurrentTick + range - 1;
+
+    const unsigned int slot = static_cast<unsigned int>((placement >> (SLOT_BITS * level)) & (SLOTS - 1));
+    const uint32_t slotIndex = level * SLOTS + slot;
+
+    node.Slot = slotIndex;
+    node.Prev = NONE;
+    node.Next = m_Slots[slotIndex];
+    if (node.Next != NONE)
+        m_Nodes[node.Next].Prev = index;
+    m_Slots[slotIndex] = index;
+    m_Occupied[level] |= 1ull << slot;
+}
+
+void TimerWheel::Unlink(uint32_t index)
+{
+    Node& node = m_Nodes[index];
+    if (node.Prev != NONE)
+        m_Nodes[node.Prev].Next = node.Next;
+    else
+        m_Slots[node.Slot] = node.Next;
+
+    if (node.Next != NONE)
+        m_Nodes[node.Next].Prev = node.Prev;
+
+    if (m_Slots[node.Slot] == NONE)
+        m_Occupied[node.Slot / SLOTS] &= ~(1ull << (node.Slot % SLOTS));
+
+    node.Prev = NONE;
+    node.Next = NONE;
+}
+
+void TimerWheel::Release(uint32_t index)
+{
+    Node& node = m_Nodes[index];
+    node.Slot = NONE;
+    node.Function = nullptr;
+    ++node.Generation; // Old ids of this node are now stale
+    m_FreeNodes.push_back(index);
+    --m_Count;
+}
+
+void TimerWheel::Cascade(unsigned int level)
+{
+    const unsigned int slot = static_cast<unsigned int>((m_CurrentTick >> (SLOT_BITS * level)) & (SLOTS - 1));
+    const uint32_t slotIndex = level * SLOTS + slot;
+
+    uint32_t index = m_Slots[slotIndex];
+    m_Slots[slotIndex] = NONE;
+    m_Occupied[level] &= ~(1ull << slot);
+
+    while (index != NONE)
+    {
+        const uint32_t next = m_Nodes[index].Next;
+        Insert(index);
+        index = next;
+    }
+}
+
+size_t TimerWheel::RunSlot()
+{
+    const uint32_t slotIndex = static_cast<uint32_t>(m_CurrentTick & (SLOTS - 1));
+    size_t fired = 0;
+
+    // The slot is read again after each callback, they can cancel timers of this slot or add new ones
+    while (m_Slots[slotIndex] != NONE)
+    {
+        const uint32_t index = m_Slots[slotIndex];
+        Unlink(index);
+
+        Node& node = m_Nodes[index];
+        if (node.ExpireTick > m_CurrentTick)
+        {
+            // Placed here with the farthest delay of the last level, it still has a round to go
+            Insert(index);
+            if (m_Slots[slotIndex] == index)
+                break;
+            continue;
+        }
+
+        Callback callback = std::move(node.Function);
+        Release(index);
+        callback();
+        ++fired;
+    }
+    return fired;
+}
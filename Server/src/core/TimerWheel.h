@@ -0,0 +1,98 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/// <summary>
+/// Hierarchical timer wheel: schedule and cancel are O(1), and advancing only looks at the slots that have timers.
+/// 4 levels of 64 slots: with 1ms ticks, the levels cover 64ms, 4s, 4min and 4.6h. Longer timers are re-cascaded.
+/// Callbacks run on the thread that calls Advance, they can schedule and cancel timers.
+/// </summary>
+class TimerWheel final
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void()>;
+    /// <summary>
+    /// Identifies a scheduled timer. Stays invalid once the timer has fired or was cancelled, even if its slot is reused.
+    /// </summary>
+    typedef uint64_t TimerId;
+    static constexpr TimerId INVALID_TIMER = 0;
+
+    explicit TimerWheel(Clock::duration tick = std::chrono::milliseconds(1));
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /// <summary>
+    /// Run `callback` once, after `delay`. (At the first Advance past the deadline, rounded up to the next tick)
+    /// </summary>
+    TimerId Schedule(Clock::duration delay, Callback callback);
+    /// <summary>
+    /// Cancel a timer.
+    /// </summary>
+    /// <returns>False if the timer already fired or was cancelled.</returns>
+    bool Cancel(TimerId id);
+    bool IsScheduled(TimerId id) const;
+
+    /// <summary>
+    /// Run the callbacks of every timer that expired at `now`.
+    /// </summary>
+    /// <returns>The number of callbacks run.</returns>
+    size_t Advance(Clock::time_point now = Clock::now());
+    /// <summary>
+    /// How long Advance can wait, in milliseconds, before a timer may expire. -1 if there is no timer.
+    /// Long timers only give the time until they have to be moved to a lower level.
+    /// </summary>
+    int GetTimeoutMs(Clock::time_point now = Clock::now()) const;
+
+    /// <summary>
+    /// Return the number of scheduled timers.
+    /// </summary>
+    size_t GetCount() const { return m_Count; }
+
+private:
+    static constexpr unsigned int LEVELS = 4;
+    static constexpr unsigned int SLOT_BITS = 6;
+    static constexpr unsigned int SLOTS = 1 << SLOT_BITS;
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Node
+    {
+        uint64_t ExpireTick = 0;
+        uint32_t Generation = 1;
+        uint32_t Prev = NONE;
+        uint32_t Next = NONE;
+        // Slot index in m_Slots, NONE while the node is free
+        uint32_t Slot = NONE;
+        Callback Function;
+    };
+
+    uint64_t ToTick(Clock::time_point time) const;
+    /// <summary>
+    /// Put a node in the slot matching its expiration, relative to the current tick.
+    /// </summary>
+    void Insert(uint32_t index);
+    void Unlink(uint32_t index);
+    void Release(uint32_t index);
+    /// <summary>
+    /// Re-insert the timers of a higher level slot, they move closer to level 0.
+    /// </summary>
+    void Cascade(unsigned int level);
+    /// <summary>
+    /// Run every timer of the level 0 slot of the current tick.
+    /// </summary>
+    size_t RunSlot();
+
+    Clock::duration m_Tick;
+    Clock::time_point m_Start;
+    uint64_t m_CurrentTick = 0;
+
+    std::vector<Node> m_Nodes;
+    std::vector<uint32_t> m_FreeNodes;
+    // First node of each slot, level after level
+    uint32_t m_Slots[LEVELS * SLOTS];
+    // Bit N is set when slot N of the level has timers
+    uint64_t m_Occupied[LEVELS] = {};
+    size_t m_Count = 0;
+};
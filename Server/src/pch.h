@@ -5,14 +5,12 @@
     This file is pre-compiled and included in all source files.
 */
 
-// For HtmlServer, who uses old window events
-#define _WINSOCK_DEPRECATED_NO_WARNINGS
-#pragma comment(lib, "User32.lib")
-
 #include <iostream>
 #include <tcp-ip/TcpIp.h>
 #include <vector>
 #include <algorithm>
+#include <functional>
+#include <unordered_map>
 #include <tcp-ip/json.hpp>
 
 #pragma region Our defines
@@ -0,0 +1,115 @@
+#include "EpollBackend.h"
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/eventfd.h>
+using enum TcpIp::ErrorCode;
+
+constexpr size_t EPOLL_INITIAL_EVENTS = 64;
+
+// The socket is stored in the low 32 bits of the user data, and the watched ReadyFlags in the high 32 bits.
+static uint64_t PackUserData(SOCKET socket, unsigned int events)
+{
+    return static_cast<uint32_t>(socket) | static_cast<uint64_t>(events) << 32;
+}
+
+EpollBackend::EpollBackend()
+    : m_EpollFd(epoll_create1(EPOLL_CLOEXEC))
+    , m_WakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    , m_Events(EPOLL_INITIAL_EVENTS)
+{
+    if (m_EpollFd == -1 || m_WakeFd == -1)
+        throw TcpIp::TcpIpException::Create(EVENT_CreateFailed, TCP_IP_WSA_ERROR);
+
+    // No ReadyFlag is packed with it, so Poll never reports it as a socket
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = PackUserData(m_WakeFd, READY_NONE);
+    if (epoll_ctl(m_EpollFd, EPOLL_CTL_ADD, m_WakeFd, &event) == -1)
+        throw TcpIp::TcpIpException::Create(EVENT_SelectFailed, TCP_IP_WSA_ERROR);
+}
+
+EpollBackend::~EpollBackend()
+{
+    close(m_WakeFd);
+    close(m_EpollFd);
+}
+
+void EpollBackend::Watch(SOCKET socket, unsigned int events)
+{
+    // Same behavior as WSAEventSelect
+    int flags = fcntl(socket, F_GETFL, 0);
+    if (flags == -1 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) == -1)
+        throw TcpIp::TcpIpException::Create(EVENT_SelectFailed, TCP_IP_WSA_ERROR);
+
+    epoll_event event = {};
+    if (events & (READY_ACCEPT | READY_READ)) event.events |= EPOLLIN;
+    if (events & READY_CLOSE) event.events |= EPOLLRDHUP;
+    if (events & READY_WRITE) event.events |= EPOLLOUT;
+    event.data.u64 = PackUserData(socket, events);
+
+    if (epoll_ctl(m_EpollFd, EPOLL_CTL_ADD, socket, &event) == 0)
+        return;
+
+    // Already watched, only change the events
+    if (errno != EEXIST || epoll_ctl(m_EpollFd, EPOLL_CTL_MOD, socket, &event) == -1)
+        throw TcpIp::TcpIpException::Create(EVENT_SelectFailed, TCP_IP_WSA_ERROR);
+}
+
+void EpollBackend::Unwatch(SOCKET socket)
+{
+    if (epoll_ctl(m_EpollFd, EPOLL_CTL_DEL, socket, nullptr) == -1 && errno != ENOENT)
+        throw TcpIp::TcpIpException::Create(EVENT_SelectFailed, TCP_IP_WSA_ERROR);
+}
+
+void EpollBackend::Poll(std::vector<ReadyEvent>& ready, int timeoutMs)
+{
+    ready.clear();
+
+    int count = epoll_wait(m_EpollFd, m_Events.data(), static_cast<int>(m_Events.size()), timeoutMs);
+    if (count == -1)
+    {
+        if (errno == EINTR) // Interrupted by a signal, nothing is ready
+            return;
+        throw TcpIp::TcpIpException::Create(EVENT_EnumFailed, TCP_IP_WSA_ERROR);
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        const epoll_event& event = m_Events[i];
+        SOCKET socket = static_cast<SOCKET>(event.data.u64 & 0xFFFFFFFF);
+        unsigned int watched = static_cast<unsigned int>(event.data.u64 >> 32);
+
+        if (socket == m_WakeFd)
+        {
+            // Reset the counter, the wake up is done
+            uint64_t value;
+            while (read(m_WakeFd, &value, sizeof(value)) > 0) {}
+            continue;
+        }
+
+        unsigned int flags = READY_NONE;
+        if (event.events & EPOLLIN)
+            flags |= (watched & READY_ACCEPT) ? READY_ACCEPT : READY_READ;
+        if (event.events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+            flags |= READY_CLOSE;
+        if (event.events & EPOLLOUT)
+            flags |= READY_WRITE;
+
+        flags &= watched;
+        if (flags != READY_NONE)
+            ready.push_back({socket, flags});
+    }
+
+    // The buffer was full, there might be more ready sockets: make room for them next time
+    if (static_cast<size_t>(count) == m_Events.size())
+        m_Events.resize(m_Events.size() * 2);
+}
+
+void EpollBackend::Wake()
+{
+    const uint64_t one = 1;
+    if (write(m_WakeFd, &one, sizeof(one)) == -1 && errno != EAGAIN) // EAGAIN: a wake up is already pending
+        throw TcpIp::TcpIpException::Create(EVENT_SelectFailed, TCP_IP_WSA_ERROR);
+}
+
+#endif // __linux__
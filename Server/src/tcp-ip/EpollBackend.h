@@ -0,0 +1,30 @@
+#pragma once
+#ifdef __linux__
+#include "ReadinessBackend.h"
+#include <sys/epoll.h>
+
+/// <summary>
+/// Readiness backend based on Linux epoll (level-triggered).
+/// The kernel only returns the sockets that are ready, so idle connections cost nothing per poll.
+/// </summary>
+class EpollBackend final : public IReadinessBackend
+{
+public:
+    EpollBackend();
+    ~EpollBackend() override;
+    EpollBackend(const EpollBackend&) = delete;
+    EpollBackend& operator=(const EpollBackend&) = delete;
+
+    void Watch(SOCKET socket, unsigned int events) override;
+    void Unwatch(SOCKET socket) override;
+    void Poll(std::vector<ReadyEvent>& ready, int timeoutMs) override;
+    void Wake() override;
+
+private:
+    int m_EpollFd;
+    // eventfd watched with the sockets, written by Wake()
+    int m_WakeFd;
+    std::vector<epoll_event> m_Events;
+};
+
+#endif // __linux__
@@ -31,7 +31,7 @@ HtmlConn::HtmlConn(SOCKET socket)
     : Socket(socket)
 {
     sockaddr_in clientAddress = {0};
-    int clientAddressLength = sizeof(clientAddress);
+    socklen_t clientAddressLength = sizeof(clientAddress);
     if (getpeername(socket, (sockaddr*)&clientAddress, &clientAddressLength) == 0)
     {
         char clientIP[INET_ADDRSTRLEN];
@@ -41,13 +41,12 @@ HtmlConn::HtmlConn(SOCKET socket)
     }
 }
 
-// Custom message for the socket events
-#define WM_SOCKET (WM_USER + 1)
-
-HtmlServer::HtmlServer()
+HtmlServer::HtmlServer(IReadinessBackend* backend)
     : m_WsaData(TcpIp::InitializeWinsock())
     , m_ListenSocket(INVALID_SOCKET)
+    , m_Backend(backend)
     , m_HtmlConns()
+    , m_HtmlConnIndices()
 {
 }
 
@@ -95,40 +94,14 @@ void HtmlServer::Open(unsigned int port)
     if (listen(m_ListenSocket, SOMAXCONN) == SOCKET_ERROR)
         throw TcpIp::TcpIpException::Create(SOCKET_ListenFailed, TCP_IP_WSA_ERROR);
 
-    // Create an invisible window for message processing
-    const std::wstring title = L"HTML SERVER " + std::to_wstring(port);
-    WNDCLASSEX wcex =
-    {
-        .cbSize = sizeof(WNDCLASSEX),
-        .style = 0,
-        .lpfnWndProc = WndProc,
-        .cbClsExtra = 0,
-        .cbWndExtra = 0,
-        .hInstance = GetModuleHandle(nullptr),
-        .hIcon = nullptr,
-        .hCursor = nullptr,
-        .hbrBackground = nullptr,
-        .lpszMenuName = nullptr,
-        .lpszClassName = title.c_str(),
-        .hIconSm = nullptr
-    };
-    RegisterClassEx(&wcex);
-    HWND hWnd = CreateWindowEx(0, title.c_str(), title.c_str(), 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, GetModuleHandle(nullptr), nullptr);
-
-    if (hWnd == nullptr)
-        throw TcpIp::TcpIpException::Create(EVENT_CreateFailed, GetLastError());
-
-    SetWindowLongPtr(hWnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
-
-    iResult = WSAAsyncSelect(m_ListenSocket, hWnd, WM_SOCKET, FD_ACCEPT | FD_READ | FD_CLOSE);
-    if (iResult != 0)
-        throw TcpIp::TcpIpException::Create(EVENT_SelectFailed, TCP_IP_WSA_ERROR);
+    m_Backend->Watch(m_ListenSocket, READY_ACCEPT);
 }
 
 void HtmlServer::Close()
 {
     if (m_ListenSocket != INVALID_SOCKET)
     {
+        m_Backend->Unwatch(m_ListenSocket);
         TcpIp::CloseSocket(m_ListenSocket);
     }
 
@@ -137,81 +110,55 @@ void HtmlServer::Close()
         if (connection.Socket == INVALID_SOCKET)
             continue; // Already closed
 
+        m_Backend->Unwatch(connection.Socket);
         TcpIp::CloseSocket(connection.Socket);
     }
     m_HtmlConns.clear();
+    m_HtmlConnIndices.clear();
 }
 
-void HtmlServer::CheckNetwork()
+void HtmlServer::CheckNetwork(const std::vector<ReadyEvent>& readyEvents)
 {
-    MSG msg;
-    while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+    for (const ReadyEvent& event : readyEvents)
     {
-        TranslateMessage(&msg);
-        DispatchMessage(&msg);
+        if (event.Socket == m_ListenSocket)
+        {
+            if (event.Flags & READY_ACCEPT)
+                AcceptPendingClients();
+            continue;
+        }
+
+        auto it = m_HtmlConnIndices.find(event.Socket);
+        if (it == m_HtmlConnIndices.end())
+            continue; // Not one of ours anymore
+
+        HtmlConn& connection = m_HtmlConns[it->second];
+        if (event.Flags & READY_READ)
+            connection.ReadPending = true;
+        if (event.Flags & READY_CLOSE)
+            connection.ClosePending = true;
     }
 }
 
-LRESULT HtmlServer::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+void HtmlServer::AcceptPendingClients()
 {
-    HtmlServer* server = reinterpret_cast<HtmlServer*>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
-
-    if (message == WM_SOCKET)
+    // The listening socket is non-blocking, accept until there is nobody left
+    while (true)
     {
-        switch (WSAGETSELECTEVENT(lParam))
-        {
-        case FD_ACCEPT:
+        SOCKET connectionSocket = accept(m_ListenSocket, nullptr, nullptr);
+        if (connectionSocket == INVALID_SOCKET)
         {
-            if (WSAGETSELECTERROR(lParam) != 0)
-                throw TcpIp::TcpIpException::Create(EVENT_FdAcceptHadError, WSAGETSELECTERROR(lParam));
-
-            SOCKET connectionSocket = accept(wParam, nullptr, nullptr);
-            if (connectionSocket == INVALID_SOCKET)
-                throw TcpIp::TcpIpException::Create(SOCKET_CreateFailed, TCP_IP_WSA_ERROR);
-
-            // Create a new connection, and place it at the end of the vector
-            int iResult = WSAAsyncSelect(connectionSocket, hWnd, WM_SOCKET, FD_READ | FD_CLOSE);
-            if (iResult != 0)
-                throw TcpIp::TcpIpException::Create(EVENT_SelectFailed, TCP_IP_WSA_ERROR);
-
-            server->m_HtmlConns.emplace_back(connectionSocket);
-            break;
+            if (TcpIp::IsWouldBlockError(WSAGetLastError()))
+                break;
+            throw TcpIp::TcpIpException::Create(SOCKET_AcceptFailed, TCP_IP_WSA_ERROR);
         }
-        case FD_READ:
-        {
-            if (WSAGETSELECTERROR(lParam) != 0)
-                throw TcpIp::TcpIpException::Create(EVENT_FdReadHadError, WSAGETSELECTERROR(lParam));
 
-            for (HtmlConn& connection : server->m_HtmlConns)
-            {
-                if (connection.Socket == wParam)
-                {
-                    connection.ReadPending = true;
-                    break;
-                }
-            }
-            break;
-        }
-        case FD_CLOSE:
-        {
-            if (WSAGETSELECTERROR(lParam) != 0)
-                throw TcpIp::TcpIpException::Create(EVENT_FdCloseHadError, WSAGETSELECTERROR(lParam));
+        m_Backend->Watch(connectionSocket, READY_READ | READY_CLOSE);
 
-            for (HtmlConn& connection : server->m_HtmlConns)
-            {
-                if (connection.Socket == wParam)
-                {
-                    connection.ClosePending = true;
-                    break;
-                }
-            }
-            break;
-        }
-        default: break;
-        }
-        return 0;
+        // Create a new connection, and place it at the end of the vector
+        m_HtmlConnIndices[connectionSocket] = m_HtmlConns.size();
+        m_HtmlConns.emplace_back(connectionSocket);
     }
-    return DefWindowProc(hWnd, message, wParam, lParam);
 }
 
 WebClientPtr HtmlServer::FindNewClient()
@@ -248,10 +195,21 @@ int HtmlServer::CleanClosedHtmlConns(std::function<void(WebClientPtr)> lastCallb
     {
         if (lastCallback != nullptr)
             lastCallback(&*it);
+        m_Backend->Unwatch(it->Socket);
         TcpIp::CloseSocket(it->Socket);
     }
 
     int closedHtmlConns = (int)std::distance(partition, m_HtmlConns.end());
     m_HtmlConns.erase(partition, m_HtmlConns.end());
+
+    // The partition moved connections around, update their indices
+    if (closedHtmlConns > 0)
+    {
+        m_HtmlConnIndices.clear();
+        for (size_t i = 0; i < m_HtmlConns.size(); ++i)
+        {
+            m_HtmlConnIndices[m_HtmlConns[i].Socket] = i;
+        }
+    }
     return closedHtmlConns;
 }
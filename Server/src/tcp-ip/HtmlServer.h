@@ -1,6 +1,7 @@
 #pragma once
-#include <WinSock2.h>
+#include "ReadinessBackend.h"
 #include <vector>
+#include <unordered_map>
 
 /// <summary>
 /// A connection to a client.
@@ -15,7 +16,6 @@ struct HtmlConn
     void Send(const std::string& data) const;
     void Kick() const;
 
-    // Creates the event object and associate it with the socket.
     HtmlConn(SOCKET socket);
 private:
     friend class HtmlServer;
@@ -35,7 +35,8 @@ typedef HtmlConn* WebClientPtr;
 class HtmlServer final
 {
 public:
-    HtmlServer();
+    /// <param name="backend">Where the sockets are watched. It is shared with the owner's main loop, which polls it.</param>
+    HtmlServer(IReadinessBackend* backend);
     ~HtmlServer();
     HtmlServer(const HtmlServer&) = delete;
     HtmlServer& operator=(const HtmlServer&) = delete;
@@ -53,11 +54,8 @@ public:
     /// <summary>
     /// Accept new connections and check all clients for pending data and close requests.
     /// </summary>
-    void CheckNetwork();
-    /// <summary>
-    /// Custom WNDPROC for the server.
-    /// </summary>
-    static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
+    /// <param name="readyEvents">Result of the last poll of the backend. Sockets that are not ours are ignored.</param>
+    void CheckNetwork(const std::vector<ReadyEvent>& readyEvents);
     /// <summary>
     /// Find a client that has just connected.
     /// </summary>
@@ -81,8 +79,18 @@ public:
     const std::vector<HtmlConn>& GetHtmlConns() { return m_HtmlConns; }
 
 private:
+    /// <summary>
+    /// Accept all the clients waiting on the listening socket.
+    /// </summary>
+    void AcceptPendingClients();
+
     WSADATA m_WsaData;
     SOCKET m_ListenSocket;
 
+    // Not owned
+    IReadinessBackend* m_Backend;
+
     std::vector<HtmlConn> m_HtmlConns;
+    // HashMap <Socket, Index in m_HtmlConns>
+    std::unordered_map<SOCKET, size_t> m_HtmlConnIndices;
 };
@@ -0,0 +1,360 @@
+#include "IoThread.h"
+using enum TcpIp::ErrorCode;
+
+// Time without accepting once the process ran out of sockets, for some to be closed
+constexpr auto ACCEPT_PAUSE_TIME = std::chrono::milliseconds(500);
+
+IoThread::IoThread(MailBox<NetworkEvent>& events, IReadinessBackend* wakeTarget, const OutboundSettings& settings)
+    : m_Events(events)
+    , m_WakeTarget(wakeTarget)
+    , m_Settings(settings)
+    , m_Backend(IReadinessBackend::Create())
+{
+}
+
+IoThread::~IoThread()
+{
+    Stop();
+    delete m_Backend;
+}
+
+void IoThread::Listen(SOCKET listenSocket, const std::vector<IoThread*>& threads)
+{
+    m_ListenSocket = listenSocket;
+    m_Threads = threads;
+    m_Backend->Watch(m_ListenSocket, READY_ACCEPT);
+}
+
+void IoThread::Start()
+{
+    m_Stopping = false;
+    m_Thread = std::thread(&IoThread::Run, this);
+}
+
+void IoThread::Stop()
+{
+    if (m_Thread.joinable())
+    {
+        m_Stopping = true;
+        m_Backend->Wake();
+        m_Thread.join();
+    }
+
+    if (m_ListenSocket != INVALID_SOCKET)
+    {
+        m_Backend->Unwatch(m_ListenSocket);
+        m_ListenSocket = INVALID_SOCKET;
+        m_IsAcceptPaused = false;
+    }
+
+    // Also called by the destructor: a socket that fails to close is only left behind
+    for (auto& [socket, connection] : m_Connections)
+    {
+        try
+        {
+            m_Backend->Unwatch(connection.Socket);
+            TcpIp::CloseSocket(connection.Socket);
+        }
+        catch (const TcpIp::TcpIpException&) {}
+    }
+    m_Connections.clear();
+
+    // Sockets handed over right before the stop were never opened, nobody else will close them
+    m_Commands.TakeAll(m_PendingCommands);
+    for (Command& command : m_PendingCommands)
+    {
+        if (command.Type != Command::Adopt)
+            continue;
+
+        try
+        {
+            TcpIp::CloseSocket(command.Socket);
+        }
+        catch (const TcpIp::TcpIpException&) {}
+    }
+    m_PendingCommands.clear();
+}
+
+void IoThread::Adopt(SOCKET socket, ConnectionId id)
+{
+    PostCommand({Command::Adopt, id, socket});
+}
+
+void IoThread::Send(ConnectionId id, SOCKET socket, SharedFrame frame, SendPolicy policy)
+{
+    PostCommand({Command::Send, id, socket, std::move(frame), policy});
+}
+
+void IoThread::Close(ConnectionId id, SOCKET socket)
+{
+    PostCommand({Command::Close, id, socket});
+}
+
+void IoThread::PostCommand(Command&& command)
+{
+    m_Commands.Push(std::move(command));
+    m_Backend->Wake();
+}
+
+void IoThread::Run()
+{
+    while (!m_Stopping)
+    {
+        try
+        {
+            m_Backend->Poll(m_ReadyEvents, GetPollTimeout());
+            HandleCommands();
+
+            for (const ReadyEvent& event : m_ReadyEvents)
+            {
+                if (event.Socket == m_ListenSocket)
+                {
+                    if (event.Flags & READY_ACCEPT)
+                        AcceptPendingClients();
+                    continue;
+                }
+
+                auto it = m_Connections.find(event.Socket);
+                if (it == m_Connections.end())
+                    continue; // Closed by a command of this iteration
+
+                // Read first, the last messages of a closing client are still wanted
+                if (event.Flags & READY_READ)
+                    ReadConnection(it->second);
+                if ((event.Flags & READY_WRITE) && m_Connections.contains(event.Socket))
+                    FlushConnection(it->second);
+                if ((event.Flags & READY_CLOSE) && m_Connections.contains(event.Socket))
+                    CloseConnection(event.Socket, true);
+            }
+        }
+        catch (const TcpIp::TcpIpException&)
+        {
+            // Not tied to a connection, let the game thread report it
+            NetworkEvent failed{NetworkEvent::Failed};
+            failed.Error = std::current_exception();
+            m_PendingEvents.push_back(std::move(failed));
+        }
+
+        if (m_PendingEvents.empty())
+            continue;
+
+        const auto now = std::chrono::steady_clock::now();
+        for (NetworkEvent& event : m_PendingEvents)
+        {
+            event.PostedAt = now;
+        }
+        m_Events.PushAll(m_PendingEvents);
+
+        if (m_WakeTarget != nullptr)
+            m_WakeTarget->Wake();
+    }
+}
+
+void IoThread::HandleCommands()
+{
+    m_Commands.TakeAll(m_PendingCommands);
+    for (Command& command : m_PendingCommands)
+    {
+        switch (command.Type)
+        {
+        case Command::Adopt:
+            OpenConnection(command.Socket, command.Id);
+            break;
+
+        case Command::Send:
+            if (IoConnection* connection = FindConnection(command.Id, command.Socket))
+                SendOnConnection(*connection, command.Frame, command.Policy);
+            break;
+
+        case Command::Close:
+            if (FindConnection(command.Id, command.Socket) != nullptr)
+                CloseConnection(command.Socket, false);
+            break;
+        }
+    }
+    m_PendingCommands.clear();
+}
+
+void IoThread::AcceptPendingClients()
+{
+    // The listening socket is non-blocking, accept until there is nobody left
+    while (true)
+    {
+        SOCKET connectionSocket = accept(m_ListenSocket, nullptr, nullptr);
+        if (connectionSocket == INVALID_SOCKET)
+        {
+            const int error = WSAGetLastError();
+            if (TcpIp::IsWouldBlockError(error))
+                break;
+            if (TcpIp::IsTransientAcceptError(error))
+                continue; // Only this client is lost
+
+            // Let the game thread report it, once: the other ready sockets of this iteration are still served
+            NetworkEvent failed{NetworkEvent::Failed};
+            failed.Error = std::make_exception_ptr(TcpIp::TcpIpException::Create(SOCKET_AcceptFailed, error));
+            m_PendingEvents.push_back(std::move(failed));
+
+            if (TcpIp::IsOutOfResourcesError(error))
+                PauseAccepting();
+            break;
+        }
+
+        // Round-robin between the I/O threads
+        IoThread* owner = m_Threads[m_NextThread];
+        m_NextThread = (m_NextThread + 1) % m_Threads.size();
+
+        if (owner == this)
+            OpenConnection(connectionSocket, m_NextId++);
+        else
+            owner->Adopt(connectionSocket, m_NextId++);
+    }
+}
+
+void IoThread::PauseAccepting()
+{
+    m_Backend->Unwatch(m_ListenSocket);
+    m_AcceptResumeTime = std::chrono::steady_clock::now() + ACCEPT_PAUSE_TIME;
+    m_IsAcceptPaused = true;
+}
+
+int IoThread::GetPollTimeout()
+{
+    if (!m_IsAcceptPaused)
+        return -1;
+
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(m_AcceptResumeTime - std::chrono::steady_clock::now());
+    if (remaining.count() > 0)
+        return static_cast<int>(remaining.count());
+
+    // The clients waiting meanwhile are still in the backlog
+    m_Backend->Watch(m_ListenSocket, READY_ACCEPT);
+    m_IsAcceptPaused = false;
+    return -1;
+}
+
+void IoThread::OpenConnection(SOCKET socket, ConnectionId id)
+{
+    m_Backend->Watch(socket, READY_READ | READY_CLOSE);
+
+    NetworkEvent opened{NetworkEvent::Opened, id, socket};
+    opened.Address = "Unknown";
+    sockaddr_in clientAddress = {};
+    socklen_t clientAddressLength = sizeof(clientAddress);
+    if (getpeername(socket, (sockaddr*)&clientAddress, &clientAddressLength) == 0)
+    {
+        char clientIP[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &(clientAddress.sin_addr), clientIP, INET_ADDRSTRLEN);
+        opened.Address = clientIP;
+        opened.Port = ntohs(clientAddress.sin_port);
+    }
+    opened.Owner = this;
+    opened.Stats = std::make_shared<ConnectionStats>();
+
+    IoConnection& connection = m_Connections[socket];
+    connection.Id = id;
+    connection.Socket = socket;
+    connection.Stats = opened.Stats;
+
+    m_PendingEvents.push_back(std::move(opened));
+}
+
+void IoThread::ReadConnection(IoConnection& connection)
+{
+    NetworkEvent received{NetworkEvent::Received, connection.Id, connection.Socket};
+    bool open;
+    try
+    {
+        open = TcpIp::ReceiveFrames(connection.Socket, connection.Decoder, received.Messages);
+    }
+    catch (const TcpIp::TcpIpException&)
+    {
+        // The stream can't be trusted anymore, drop the client
+        open = false;
+    }
+
+    const SOCKET socket = connection.Socket;
+    if (!received.Messages.empty())
+        m_PendingEvents.push_back(std::move(received));
+    if (!open)
+        CloseConnection(socket, true);
+}
+
+void IoThread::SendOnConnection(IoConnection& connection, const SharedFrame& frame, SendPolicy policy)
+{
+    if (connection.Stats->Congested && policy == SendPolicy::Droppable)
+    {
+        ++connection.Stats->DroppedMessages;
+        return;
+    }
+
+    if (connection.Outbound.GetQueuedBytes() + frame->size() > m_Settings.KickThreshold)
+    {
+        // The client stopped reading, holding more for it would only waste memory
+        CloseConnection(connection.Socket, true);
+        return;
+    }
+
+    try
+    {
+        connection.Outbound.Push(connection.Socket, frame);
+    }
+    catch (const TcpIp::TcpIpException&)
+    {
+        CloseConnection(connection.Socket, true);
+        return;
+    }
+    OnOutboundChanged(connection);
+}
+
+void IoThread::FlushConnection(IoConnection& connection)
+{
+    try
+    {
+        connection.Outbound.Flush(connection.Socket);
+    }
+    catch (const TcpIp::TcpIpException&)
+    {
+        CloseConnection(connection.Socket, true);
+        return;
+    }
+    OnOutboundChanged(connection);
+}
+
+void IoThread::OnOutboundChanged(IoConnection& connection)
+{
+    ConnectionStats& stats = *connection.Stats;
+    const size_t queued = connection.Outbound.GetQueuedBytes();
+    stats.QueuedBytes = queued;
+    stats.QueuedMessages = connection.Outbound.GetQueuedFrames();
+    if (queued > m_Settings.HighWatermark)
+        stats.Congested = true;
+    else if (queued <= m_Settings.LowWatermark)
+        stats.Congested = false;
+
+    // Write readiness is only interesting while something is waiting
+    const bool wantWrite = !connection.Outbound.IsEmpty();
+    if (wantWrite == connection.WatchingWrite)
+        return;
+
+    m_Backend->Watch(connection.Socket, wantWrite ? READY_READ | READY_CLOSE | READY_WRITE : READY_READ | READY_CLOSE);
+    connection.WatchingWrite = wantWrite;
+}
+
+void IoThread::CloseConnection(SOCKET socket, bool notify)
+{
+    auto it = m_Connections.find(socket);
+    if (notify)
+        m_PendingEvents.push_back({NetworkEvent::Closed, it->second.Id, socket});
+
+    m_Backend->Unwatch(socket);
+    TcpIp::CloseSocket(socket);
+    m_Connections.erase(it);
+}
+
+IoThread::IoConnection* IoThread::FindConnection(ConnectionId id, SOCKET socket)
+{
+    auto it = m_Connections.find(socket);
+    if (it == m_Connections.end() || it->second.Id != id)
+        return nullptr;
+    return &it->second;
+}
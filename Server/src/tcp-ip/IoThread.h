@@ -0,0 +1,202 @@
+#pragma once
+#include "ReadinessBackend.h"
+#include "OutboundQueue.h"
+#include "MailBox.h"
+#include <tcp-ip/FrameDecoder.h>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+class IoThread;
+
+/// <summary>
+/// Identifies a connection for its whole life. Unlike sockets, ids are never reused.
+/// </summary>
+typedef uint64_t ConnectionId;
+
+/// <summary>
+/// State of the outbound queue of a connection, written by its I/O thread and read by the game thread.
+/// </summary>
+struct ConnectionStats
+{
+    std::atomic<size_t> QueuedBytes = 0;
+    std::atomic<size_t> QueuedMessages = 0;
+    std::atomic<size_t> DroppedMessages = 0;
+    std::atomic<bool> Congested = false;
+};
+
+/// <summary>
+/// Something that happened on a connection, posted by an I/O thread for the game thread.
+/// </summary>
+struct NetworkEvent
+{
+    enum EventType
+    {
+        // A client was accepted. Address, Port, Owner and Stats are set.
+        Opened,
+        // Complete frames were received. Messages is set.
+        Received,
+        // The connection was closed by the I/O thread. (Peer left, error, or kicked for not reading)
+        Closed,
+        // The I/O thread hit an error that is not tied to a connection. Error is set.
+        Failed,
+    };
+
+    NetworkEvent(EventType type, ConnectionId id = 0, SOCKET socket = INVALID_SOCKET)
+        : Type(type)
+        , Id(id)
+        , Socket(socket)
+    {
+    }
+
+    EventType Type;
+    ConnectionId Id = 0;
+    SOCKET Socket = INVALID_SOCKET;
+
+    std::string Address;
+    unsigned int Port = 0;
+    IoThread* Owner = nullptr;
+    std::shared_ptr<ConnectionStats> Stats;
+
+    std::vector<TcpIp::Frame> Messages;
+    std::exception_ptr Error;
+
+    // When the I/O thread handed the event to the game thread
+    std::chrono::steady_clock::time_point PostedAt;
+};
+
+/// <summary>
+/// A thread that does the network work of a share of the connections: accepting, reading & decoding frames, sending.
+/// It owns its sockets, everything else talks to it through its mail box.
+/// </summary>
+class IoThread final
+{
+public:
+    /// <param name="events">Where the events of this thread's connections are posted.</param>
+    /// <param name="wakeTarget">Woken up after events are posted, can be null.</param>
+    IoThread(MailBox<NetworkEvent>& events, IReadinessBackend* wakeTarget, const OutboundSettings& settings);
+    ~IoThread();
+    IoThread(const IoThread&) = delete;
+    IoThread& operator=(const IoThread&) = delete;
+
+    /// <summary>
+    /// Make this thread accept the clients of a listening socket, and hand them out to `threads` in turn.
+    /// Must be called before Start.
+    /// </summary>
+    void Listen(SOCKET listenSocket, const std::vector<IoThread*>& threads);
+    void Start();
+    /// <summary>
+    /// Stop the thread and close all its connections, the adopted ones it had not opened yet included.
+    /// The listening socket is left to its owner.
+    /// </summary>
+    void Stop();
+
+    /// <summary>
+    /// Give an accepted socket to this thread. (Thread safe)
+    /// </summary>
+    void Adopt(SOCKET socket, ConnectionId id);
+    /// <summary>
+    /// Send a message on one of this thread's connections. (Thread safe)
+    /// </summary>
+    void Send(ConnectionId id, SOCKET socket, SharedFrame frame, SendPolicy policy);
+    /// <summary>
+    /// Close one of this thread's connections. (Thread safe)
+    /// </summary>
+    void Close(ConnectionId id, SOCKET socket);
+
+private:
+    struct Command
+    {
+        enum CommandType { Adopt, Send, Close };
+
+        Command(CommandType type, ConnectionId id, SOCKET socket, SharedFrame frame = nullptr, SendPolicy policy = SendPolicy::Critical)
+            : Type(type)
+            , Id(id)
+            , Socket(socket)
+            , Frame(std::move(frame))
+            , Policy(policy)
+        {
+        }
+
+        CommandType Type;
+        ConnectionId Id;
+        SOCKET Socket;
+        SharedFrame Frame;
+        SendPolicy Policy;
+    };
+
+    /// <summary>
+    /// The socket side of a connection.
+    /// </summary>
+    struct IoConnection
+    {
+        ConnectionId Id;
+        SOCKET Socket;
+        // Keeps the bytes of incomplete messages between two reads
+        TcpIp::FrameDecoder Decoder;
+        OutboundQueue Outbound;
+        std::shared_ptr<ConnectionStats> Stats;
+        bool WatchingWrite = false;
+    };
+
+    void Run();
+    void PostCommand(Command&& command);
+    void HandleCommands();
+    /// <summary>
+    /// Accept every pending client. Never throws: errors are reported to the game thread.
+    /// </summary>
+    void AcceptPendingClients();
+    /// <summary>
+    /// Stop watching the listening socket for a while: it stays readable while no socket can be created.
+    /// </summary>
+    void PauseAccepting();
+    /// <summary>
+    /// Returns how long Poll can wait, until accepting resumes. -1 waits forever.
+    /// </summary>
+    int GetPollTimeout();
+
+    void OpenConnection(SOCKET socket, ConnectionId id);
+    void ReadConnection(IoConnection& connection);
+    void SendOnConnection(IoConnection& connection, const SharedFrame& frame, SendPolicy policy);
+    void FlushConnection(IoConnection& connection);
+    /// <summary>
+    /// Update the stats and the watched events after the outbound queue changed.
+    /// </summary>
+    void OnOutboundChanged(IoConnection& connection);
+    /// <summary>
+    /// Close the socket, and tell the game thread if it did not ask for it.
+    /// </summary>
+    void CloseConnection(SOCKET socket, bool notify);
+    /// <summary>
+    /// Find a connection, checking the id in case the socket was closed and reused.
+    /// </summary>
+    IoConnection* FindConnection(ConnectionId id, SOCKET socket);
+
+    MailBox<NetworkEvent>& m_Events;
+    IReadinessBackend* m_WakeTarget;
+    const OutboundSettings m_Settings;
+
+    IReadinessBackend* m_Backend;
+    std::vector<ReadyEvent> m_ReadyEvents;
+    MailBox<Command> m_Commands;
+    std::vector<Command> m_PendingCommands;
+    // Events of this iteration, posted together
+    std::vector<NetworkEvent> m_PendingEvents;
+
+    SOCKET m_ListenSocket = INVALID_SOCKET;
+    std::vector<IoThread*> m_Threads;
+    size_t m_NextThread = 0;
+    ConnectionId m_NextId = 1;
+    // Set while accepting is paused, out of sockets
+    std::chrono::steady_clock::time_point m_AcceptResumeTime;
+    bool m_IsAcceptPaused = false;
+
+    // HashMap <Socket, Connection>
+    std::unordered_map<SOCKET, IoConnection> m_Connections;
+
+    std::thread m_Thread;
+    std::atomic<bool> m_Stopping = false;
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <mutex>
+#include <vector>
+
+/// <summary>
+/// A queue to pass items from one or more threads to another one.
+/// Items are taken all at once, so the lock is only held to swap vectors.
+/// </summary>
+template<typename T>
+class MailBox final
+{
+public:
+    void Push(T&& item)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Items.push_back(std::move(item));
+    }
+
+    /// <summary>
+    /// Move all the items at the end of the mail box. `items` is left empty.
+    /// </summary>
+    void PushAll(std::vector<T>& items)
+    {
+        if (items.empty())
+            return;
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Items.empty())
+            m_Items.swap(items);
+        else
+        {
+            for (T& item : items)
+            {
+                m_Items.push_back(std::move(item));
+            }
+        }
+        items.clear();
+    }
+
+    /// <summary>
+    /// Take every item in the mail box. (`items` is cleared first)
+    /// </summary>
+    void TakeAll(std::vector<T>& items)
+    {
+        items.clear();
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Items.swap(items);
+    }
+
+private:
+    std::mutex m_Mutex;
+    std::vector<T> m_Items;
+};
@@ -0,0 +1,61 @@
+#include "OutboundQueue.h"
+#include <cstring>
+
+SharedFrame MakeFrame(std::string_view data, TcpIp::FrameInfo info)
+{
+    std::string frame(TcpIp::HEADER_SIZE + data.size(), '\0');
+    TcpIp::WriteHeader(frame.data(), static_cast<u_long>(data.size()), info);
+    memcpy(frame.data() + TcpIp::HEADER_SIZE, data.data(), data.size());
+    return std::make_shared<const std::string>(std::move(frame));
+}
+
+void OutboundQueue::Push(const SOCKET& socket, const SharedFrame& frame)
+{
+    size_t sent = 0;
+    if (m_Frames.empty())
+    {
+        // Nothing waiting, the frame can go out directly
+        const TcpIp::SendBuffer buffer = {frame->data(), frame->size()};
+        sent = TcpIp::TrySend(socket, &buffer, 1);
+        if (sent == frame->size())
+            return;
+        m_FrontSent = sent;
+    }
+
+    m_Frames.push_back(frame);
+    m_QueuedBytes += frame->size() - sent;
+}
+
+void OutboundQueue::Flush(const SOCKET& socket)
+{
+    while (!m_Frames.empty())
+    {
+        // Gather as many frames as one call can take, skipping what was already sent of the first one
+        TcpIp::SendBuffer buffers[TcpIp::MAX_SEND_BUFFERS];
+        size_t count = 0;
+        size_t expected = 0;
+        size_t skip = m_FrontSent;
+        for (auto it = m_Frames.begin(); it != m_Frames.end() && count < TcpIp::MAX_SEND_BUFFERS; ++it)
+        {
+            buffers[count++] = {(*it)->data() + skip, (*it)->size() - skip};
+            expected += (*it)->size() - skip;
+            skip = 0;
+        }
+
+        const size_t sent = TcpIp::TrySend(socket, buffers, count);
+        m_QueuedBytes -= sent;
+
+        // Drop the frames that are completely sent
+        size_t consumed = m_FrontSent + sent;
+        while (!m_Frames.empty() && consumed >= m_Frames.front()->size())
+        {
+            consumed -= m_Frames.front()->size();
+            m_Frames.pop_front();
+        }
+        m_FrontSent = consumed;
+
+        // The socket buffer is full, wait for the next write readiness
+        if (sent < expected)
+            break;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <tcp-ip/TcpIp.h>
+#include <deque>
+#include <memory>
+#include <string_view>
+
+/// <summary>
+/// A whole frame, header included, immutable once it is handed to the network.
+/// A message is encoded and framed once, then shared by the queues of all the connections it goes to instead of copied in each.
+/// </summary>
+typedef std::shared_ptr<const std::string> SharedFrame;
+
+/// <summary>
+/// Frame data that was encoded without a header, copying it once. (Messages can be encoded framed, see EncodeFrame)
+/// </summary>
+SharedFrame MakeFrame(std::string_view data, TcpIp::FrameInfo info);
+
+/// <summary>
+/// How important a message is when the client can't keep up.
+/// </summary>
+enum class SendPolicy
+{
+    // Always queued, the client is kicked if too much is waiting
+    Critical,
+    // Dropped while the connection is congested, the client will get a newer one later (eg: lobby list refreshes)
+    Droppable,
+};
+
+/// <summary>
+/// Limits of the data waiting to be sent to one connection.
+/// </summary>
+struct OutboundSettings
+{
+    // Above this many queued bytes the connection is congested: droppable messages are not sent anymore.
+    size_t HighWatermark = 64 * 1024;
+    // The congestion ends when the queue goes back below this many bytes.
+    size_t LowWatermark = 16 * 1024;
+    // A client that lets this many bytes pile up is not reading anymore, it is kicked.
+    size_t KickThreshold = 1024 * 1024;
+};
+
+/// <summary>
+/// Frames that could not be sent right away because the socket buffer was full.
+/// While the queue is empty, frames are sent directly from their shared buffer and nothing is copied.
+/// </summary>
+class OutboundQueue final
+{
+public:
+    OutboundQueue() = default;
+
+    /// <summary>
+    /// Sends a frame, or queues it after the frames already waiting. The queue keeps a reference to the frame, it is never copied.
+    /// Throws if the socket has an error.
+    /// </summary>
+    void Push(const SOCKET& socket, const SharedFrame& frame);
+    /// <summary>
+    /// Sends as many queued frames as the socket accepts. Throws if the socket has an error.
+    /// </summary>
+    void Flush(const SOCKET& socket);
+
+    /// <summary>
+    /// Returns the number of bytes waiting to be sent.
+    /// </summary>
+    size_t GetQueuedBytes() const { return m_QueuedBytes; }
+    /// <summary>
+    /// Returns the number of frames waiting to be sent, including a partially sent one.
+    /// </summary>
+    size_t GetQueuedFrames() const { return m_Frames.size(); }
+    bool IsEmpty() const { return m_Frames.empty(); }
+
+private:
+    std::deque<SharedFrame> m_Frames;
+    // Bytes of the first frame that were already sent
+    size_t m_FrontSent = 0;
+    size_t m_QueuedBytes = 0;
+};
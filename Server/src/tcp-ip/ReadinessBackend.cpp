@@ -0,0 +1,14 @@
+#include "ReadinessBackend.h"
+#include "EpollBackend.h"
+#include "WsaPollBackend.h"
+
+IReadinessBackend* IReadinessBackend::Create()
+{
+#if defined(__linux__)
+    return new EpollBackend();
+#elif defined(_WIN32)
+    return new WsaPollBackend();
+#else
+#error No readiness backend for this platform
+#endif
+}
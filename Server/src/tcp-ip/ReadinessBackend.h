@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+
+/// <summary>
+/// Network events a socket can be watched for. (Same idea as FD_ACCEPT / FD_READ / FD_CLOSE / FD_WRITE)
+/// </summary>
+enum ReadyFlag : unsigned int
+{
+    READY_NONE = 0,
+    READY_ACCEPT = 1 << 0,
+    READY_READ = 1 << 1,
+    READY_CLOSE = 1 << 2,
+    // The socket can accept more data after a send would have blocked.
+    // Only watch it while there is something waiting to be sent, or it will be ready all the time.
+    READY_WRITE = 1 << 3,
+};
+
+/// <summary>
+/// A socket that has at least one of its watched events ready.
+/// </summary>
+struct ReadyEvent
+{
+    SOCKET Socket;
+    unsigned int Flags;
+};
+
+/// <summary>
+/// Tells which of the watched sockets are ready, so the servers do not have to ask every connection on every tick.
+/// Like WSAEventSelect, watching a socket puts it in non-blocking mode.
+/// </summary>
+class IReadinessBackend
+{
+public:
+    virtual ~IReadinessBackend() = default;
+
+    /// <summary>
+    /// Start watching a socket for the given events. (Combination of ReadyFlag)
+    /// Watching an already watched socket replaces its events.
+    /// </summary>
+    virtual void Watch(SOCKET socket, unsigned int events) = 0;
+    /// <summary>
+    /// Stop watching a socket. Must be called before the socket is closed.
+    /// </summary>
+    virtual void Unwatch(SOCKET socket) = 0;
+    /// <summary>
+    /// Fill `ready` with the sockets that have pending events. (The vector is cleared first)
+    /// </summary>
+    /// <param name="timeoutMs">How long to wait for an event. 0 returns immediately, -1 waits forever.</param>
+    virtual void Poll(std::vector<ReadyEvent>& ready, int timeoutMs) = 0;
+    /// <summary>
+    /// Make a Poll that is waiting (or the next one) return early.
+    /// This is the only method that can be called from another thread.
+    /// </summary>
+    virtual void Wake() = 0;
+
+    /// <summary>
+    /// Create the best backend available on this platform.
+    /// The caller is responsible for the pointer created!
+    /// </summary>
+    static IReadinessBackend* Create();
+};
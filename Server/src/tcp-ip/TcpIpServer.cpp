@@ -6,47 +6,88 @@ std::string Connection::GetName() const
     return Address + ":" + std::to_string(Port);
 }
 
-std::string Connection::Receive() const
+std::vector<TcpIp::Frame> Connection::Receive() const
 {
     if (!ReadPending)
         throw TcpIp::TcpIpException::Create(SOCKET_NoDataAvailable);
 
-    std::stringstream ss;
-    TcpIp::Receive(Socket, ss, DEFAULT_BUFFER_SIZE);
+    std::vector<TcpIp::Frame> messages;
+    const size_t budget = Server->m_MessageBudget;
+    if (InboxRead == 0 && (budget == 0 || Inbox.size() <= budget))
+    {
+        // Everything fits, hand the whole inbox over
+        messages.swap(Inbox);
+    }
+    else
+    {
+        const size_t available = Inbox.size() - InboxRead;
+        const size_t count = budget == 0 || available < budget ? available : budget;
+        messages.reserve(count);
+        for (size_t i = InboxRead; i < InboxRead + count; ++i)
+        {
+            messages.push_back(std::move(Inbox[i]));
+        }
+        InboxRead += count;
+
+        if (InboxRead < Inbox.size())
+            return messages; // The rest is for the next tick
+        Inbox.clear();
+    }
+
+    InboxRead = 0;
     ReadPending = false;
-    return ss.str();
+    return messages;
 }
 
-void Connection::Send(const std::string& data) const
+void Connection::Send(std::string_view data, TcpIp::FrameInfo info, SendPolicy policy)
 {
-    TcpIp::Send(Socket, data.c_str(), static_cast<u_long>(data.size()));
+    Send(MakeFrame(data, info), policy);
+}
+
+void Connection::Send(SharedFrame frame, SendPolicy policy)
+{
+    if (ClosePending)
+        return; // Nobody will read it
+
+    // Save the trip to the I/O thread, it would drop it too
+    if (policy == SendPolicy::Droppable && Stats->Congested)
+    {
+        ++Stats->DroppedMessages;
+        return;
+    }
+
+    Owner->Send(Id, Socket, std::move(frame), policy);
 }
 
 void Connection::Kick() const
 {
+    if (ClosePending)
+        return;
+
     ClosePending = true;
+    Server->m_ClosingConnections.push_back(Handle);
 }
 
-Connection::Connection(SOCKET socket)
-    : Socket(socket)
-    , Event(TcpIp::CreateEventObject(socket, FD_READ | FD_CLOSE))
+Connection::Connection(const NetworkEvent& opened)
+    : Address(opened.Address)
+    , Port(opened.Port)
+    , Id(opened.Id)
+    , Socket(opened.Socket)
+    , Owner(opened.Owner)
+    , Stats(opened.Stats)
 {
-    sockaddr_in clientAddress = {0};
-    int clientAddressLength = sizeof(clientAddress);
-    if (getpeername(socket, (sockaddr*)&clientAddress, &clientAddressLength) == 0)
-    {
-        char clientIP[INET_ADDRSTRLEN];
-        inet_ntop(AF_INET, &(clientAddress.sin_addr), clientIP, INET_ADDRSTRLEN);
-        Address = clientIP;
-        Port = ntohs(clientAddress.sin_port);
-    }
 }
 
 TcpIpServer::TcpIpServer()
     : m_WsaData(TcpIp::InitializeWinsock())
     , m_ListenSocket(INVALID_SOCKET)
-    , m_AcceptEvent(WSA_INVALID_EVENT)
+    , m_OutboundSettings()
+    , m_WakeTarget(nullptr)
+    , m_IoThreads()
+    , m_Events()
+    , m_ReceivedEvents()
     , m_Connections()
+    , m_ConnectionHandles()
 {
 }
 
@@ -55,7 +96,7 @@ TcpIpServer::~TcpIpServer()
     Close();
 }
 
-void TcpIpServer::Open(unsigned int port)
+void TcpIpServer::Open(unsigned int port, unsigned int ioThreadCount)
 {
     ADDRINFO* result = nullptr;
     ADDRINFO hints
@@ -94,129 +135,183 @@ void TcpIpServer::Open(unsigned int port)
     if (listen(m_ListenSocket, SOMAXCONN) == SOCKET_ERROR)
         throw TcpIp::TcpIpException::Create(SOCKET_ListenFailed, TCP_IP_WSA_ERROR);
 
-    m_AcceptEvent = TcpIp::CreateEventObject(m_ListenSocket, FD_ACCEPT);
+    if (ioThreadCount == 0)
+        ioThreadCount = 1;
+    for (unsigned int i = 0; i < ioThreadCount; ++i)
+    {
+        m_IoThreads.push_back(new IoThread(m_Events, m_WakeTarget, m_OutboundSettings));
+    }
+
+    // The first thread accepts the clients and deals them to all threads
+    m_IoThreads[0]->Listen(m_ListenSocket, m_IoThreads);
+    for (IoThread* ioThread : m_IoThreads)
+    {
+        ioThread->Start();
+    }
 }
 
 void TcpIpServer::Close()
 {
-    if (m_ListenSocket != INVALID_SOCKET)
+    // Stopping the threads closes their connections
+    for (IoThread* ioThread : m_IoThreads)
     {
-        TcpIp::CloseEventObject(m_AcceptEvent);
-        TcpIp::CloseSocket(m_ListenSocket);
+        RELEASE(ioThread);
     }
+    m_IoThreads.clear();
 
-    for (Connection& connection : m_Connections)
-    {
-        if (connection.Socket == INVALID_SOCKET)
-            continue; // Already closed
+    if (m_ListenSocket != INVALID_SOCKET)
+        TcpIp::CloseSocket(m_ListenSocket);
 
-        TcpIp::CloseEventObject(connection.Event);
-        TcpIp::CloseSocket(connection.Socket);
-    }
-    m_Connections.clear();
+    m_Connections.Clear();
+    m_ConnectionHandles.clear();
+    m_NewConnections.clear();
+    m_ReadableConnections.clear();
+    m_DeferredConnections.clear();
+    m_ClosingConnections.clear();
+    m_LastServed = INVALID_CONNECTION;
 }
 
 void TcpIpServer::CheckNetwork()
 {
-    WSANETWORKEVENTS networkEvents;
-
-    // Check for accept events
-    int iResult = WSAEnumNetworkEvents(m_ListenSocket, m_AcceptEvent, &networkEvents);
-    if (iResult == SOCKET_ERROR)
-        throw TcpIp::TcpIpException::Create(EVENT_EnumFailed, TCP_IP_WSA_ERROR);
+    m_Events.TakeAll(m_ReceivedEvents);
 
-    while (networkEvents.lNetworkEvents & FD_ACCEPT)
+    // A new tick: the clients left over by the budget go first, in the order they were served
+    DeferLastServed();
+    while (!m_DeferredConnections.empty())
     {
-        if (networkEvents.iErrorCode[FD_ACCEPT_BIT] != 0)
-            throw TcpIp::TcpIpException::Create(EVENT_FdAcceptHadError, networkEvents.iErrorCode[FD_ACCEPT_BIT]);
-
-        SOCKET connectionSocket = accept(m_ListenSocket, nullptr, nullptr);
-        if (connectionSocket == INVALID_SOCKET)
-            throw TcpIp::TcpIpException::Create(SOCKET_CreateFailed, TCP_IP_WSA_ERROR);
-
-        // Create a new connection, and place it at the end of the vector
-        m_Connections.emplace_back(connectionSocket);
-
-        int iResult = WSAEnumNetworkEvents(m_ListenSocket, m_AcceptEvent, &networkEvents);
-        if (iResult == SOCKET_ERROR)
-            throw TcpIp::TcpIpException::Create(EVENT_EnumFailed, TCP_IP_WSA_ERROR);
+        m_ReadableConnections.push_back(m_DeferredConnections.front());
+        m_DeferredConnections.pop_front();
     }
 
-    // Check for read/close events on all connections
-    for (Connection& connection : m_Connections)
+    std::exception_ptr error;
+    for (NetworkEvent& event : m_ReceivedEvents)
     {
-        int iResult = WSAEnumNetworkEvents(connection.Socket, connection.Event, &networkEvents);
-        if (iResult == SOCKET_ERROR)
-            throw TcpIp::TcpIpException::Create(EVENT_EnumFailed, TCP_IP_WSA_ERROR);
-
-        if (networkEvents.lNetworkEvents & FD_READ)
+        if (event.Type == NetworkEvent::Failed)
         {
-            if (networkEvents.iErrorCode[FD_READ_BIT] != 0)
-                throw TcpIp::TcpIpException::Create(EVENT_FdReadHadError, networkEvents.iErrorCode[FD_READ_BIT]);
+            // Report the first one once everything else is applied
+            if (error == nullptr)
+                error = event.Error;
+            continue;
+        }
 
-            connection.ReadPending = true;
+        if (event.Type == NetworkEvent::Opened)
+        {
+            const ConnectionHandle handle = m_Connections.Emplace(event);
+            Connection* connection = m_Connections.Get(handle);
+            connection->Handle = handle;
+            connection->Server = this;
+            m_ConnectionHandles[event.Id] = handle;
+            m_NewConnections.push_back(handle);
+            continue;
         }
 
-        if (networkEvents.lNetworkEvents & FD_CLOSE)
+        auto it = m_ConnectionHandles.find(event.Id);
+        if (it == m_ConnectionHandles.end())
+            continue; // Already cleaned
+
+        Connection& connection = *m_Connections.Get(it->second);
+        if (event.Type == NetworkEvent::Received)
         {
-            if (networkEvents.iErrorCode[FD_CLOSE_BIT] != 0)
-                throw TcpIp::TcpIpException::Create(EVENT_FdCloseHadError, networkEvents.iErrorCode[FD_CLOSE_BIT]);
+            if (connection.Inbox.empty())
+            {
+                connection.Inbox = std::move(event.Messages);
+                connection.InboxTime = event.PostedAt;
+            }
+            else
+            {
+                for (TcpIp::Frame& message : event.Messages)
+                {
+                    connection.Inbox.push_back(std::move(message));
+                }
+            }
+            connection.ReadPending = true;
 
-            connection.ClosePending = true;
+            if (!connection.ReadQueued)
+            {
+                connection.ReadQueued = true;
+                m_ReadableConnections.push_back(connection.Handle);
+            }
+        }
+        else if (event.Type == NetworkEvent::Closed)
+        {
+            connection.Closed = true;
+            connection.Kick();
         }
     }
+
+    if (error != nullptr)
+        std::rethrow_exception(error);
 }
 
 ClientPtr TcpIpServer::FindNewClient()
 {
-    for (Connection& connection : m_Connections)
+    while (!m_NewConnections.empty())
     {
-        if (connection.IsNew)
-        {
-            connection.IsNew = false;
-            return &connection;
-        }
+        const ConnectionHandle handle = m_NewConnections.front();
+        m_NewConnections.pop_front();
+
+        if (Connection* connection = m_Connections.Get(handle))
+            return connection;
     }
     return nullptr;
 }
 
 ClientPtr TcpIpServer::FindClientWithPendingData()
 {
-    for (Connection& connection : m_Connections)
+    DeferLastServed();
+
+    while (!m_ReadableConnections.empty())
     {
-        if (connection.ReadPending)
-            return &connection;
+        const ConnectionHandle handle = m_ReadableConnections.front();
+        m_ReadableConnections.pop_front();
+
+        Connection* connection = m_Connections.Get(handle);
+        if (!connection)
+            continue; // Cleaned since
+
+        connection->ReadQueued = false;
+        if (!connection->ReadPending)
+            continue;
+
+        m_LastServed = handle;
+        return connection;
     }
     return nullptr;
 }
 
-int TcpIpServer::CleanClosedConnections(std::function<void(ClientPtr)> lastCallback)
+void TcpIpServer::DeferLastServed()
 {
-    // Move all connections that have a close pending to the end of the vector
-    auto partition = std::partition(m_Connections.begin(), m_Connections.end(),
-        [](const Connection& connection) { return !connection.ClosePending; });
+    Connection* connection = m_Connections.Get(m_LastServed);
+    m_LastServed = INVALID_CONNECTION;
 
-    // Close them all & remove them from the vector
-    for (auto it = partition; it != m_Connections.end(); ++it)
+    if (connection && connection->ReadPending && !connection->ReadQueued)
     {
-        if (lastCallback != nullptr)
-            lastCallback(&*it);
-        TcpIp::CloseEventObject(it->Event);
-        TcpIp::CloseSocket(it->Socket);
+        connection->ReadQueued = true;
+        m_DeferredConnections.push_back(connection->Handle);
     }
-
-    int closedConnections = (int)std::distance(partition, m_Connections.end());
-    m_Connections.erase(partition, m_Connections.end());
-    return closedConnections;
 }
 
-ClientPtr TcpIpServer::GetClientByName(const std::string& name)
+int TcpIpServer::CleanClosedConnections(std::function<void(ClientPtr)> lastCallback)
 {
-    for (Connection& connection : m_Connections)
+    int closedConnections = 0;
+
+    // The callback can kick other clients, they are appended and closed in the same call
+    for (size_t i = 0; i < m_ClosingConnections.size(); ++i)
     {
-        if (connection.GetName() == name)
-            return &connection;
+        Connection* connection = m_Connections.Get(m_ClosingConnections[i]);
+        if (!connection)
+            continue;
+
+        if (lastCallback != nullptr)
+            lastCallback(connection);
+        if (!connection->Closed)
+            connection->Owner->Close(connection->Id, connection->Socket);
+
+        m_ConnectionHandles.erase(connection->Id);
+        m_Connections.Erase(connection->Handle);
+        ++closedConnections;
     }
+    m_ClosingConnections.clear();
 
-    return nullptr;
+    return closedConnections;
 }
@@ -1,40 +1,99 @@
 #pragma once
-#include <WinSock2.h>
+#include "IoThread.h"
+#include "src/core/SlotMap.h"
+#include <deque>
 #include <vector>
+#include <unordered_map>
 
 /// <summary>
-/// A connection to a client.
+/// A handle to a connection, that can be stored.
+/// It is never reused, TcpIpServer::GetClient returns nullptr once its connection is cleaned.
+/// </summary>
+typedef SlotHandle ConnectionHandle;
+constexpr ConnectionHandle INVALID_CONNECTION = INVALID_SLOT_HANDLE;
+
+class TcpIpServer;
+
+/// <summary>
+/// A connection to a client, as seen by the game thread.
+/// The socket itself belongs to one of the I/O threads, sends and kicks are forwarded to it.
 /// </summary>
 struct Connection
 {
     std::string Address = "Unknown";
     unsigned int Port = 0;
     std::string GetName() const;
+    ConnectionHandle GetHandle() const { return Handle; }
 
-    std::string Receive() const;
-    void Send(const std::string& data) const;
+    /// <summary>
+    /// Receive the frames decoded since the last call. (There can be several)
+    /// At most the message budget of the server is returned, the rest waits for the next tick.
+    /// </summary>
+    std::vector<TcpIp::Frame> Receive() const;
+    /// <summary>
+    /// Send a message without blocking. It is handed to the I/O thread of the connection,
+    /// which sends it right away or queues it until the socket is writable.
+    /// </summary>
+    /// <param name="info">Written in the frame header, so the client can route the message before reading it.</param>
+    void Send(std::string_view data, TcpIp::FrameInfo info = {}, SendPolicy policy = SendPolicy::Critical);
+    /// <summary>
+    /// Send a frame that already has its header, it may be shared with other connections. It is not copied.
+    /// </summary>
+    void Send(SharedFrame frame, SendPolicy policy = SendPolicy::Critical);
     void Kick() const;
 
-    // Creates the event object and associate it with the socket.
-    Connection(SOCKET socket);
+    /// <summary>
+    /// Return the number of bytes waiting to be sent.
+    /// </summary>
+    size_t GetQueuedBytes() const { return Stats->QueuedBytes; }
+    /// <summary>
+    /// Return the number of messages waiting to be sent.
+    /// </summary>
+    size_t GetQueuedMessages() const { return Stats->QueuedMessages; }
+    /// <summary>
+    /// Return the number of droppable messages that were not sent because of congestion.
+    /// </summary>
+    size_t GetDroppedMessages() const { return Stats->DroppedMessages; }
+    /// <summary>
+    /// True when the queue went above the high watermark, until it goes back below the low watermark.
+    /// </summary>
+    bool IsCongested() const { return Stats->Congested; }
+    /// <summary>
+    /// Return when the oldest message not received yet was handed over by the I/O thread.
+    /// </summary>
+    std::chrono::steady_clock::time_point GetInboxTime() const { return InboxTime; }
+
+    Connection(const NetworkEvent& opened);
 private:
     friend class TcpIpServer;
 
+    ConnectionHandle Handle = INVALID_CONNECTION;
+    TcpIpServer* Server = nullptr;
+    ConnectionId Id;
     SOCKET Socket;
-    WSAEVENT Event;
+    IoThread* Owner;
+    std::shared_ptr<ConnectionStats> Stats;
+    // Messages received by the I/O thread, waiting for Receive(). The first InboxRead ones were already received.
+    mutable std::vector<TcpIp::Frame> Inbox;
+    mutable size_t InboxRead = 0;
+    std::chrono::steady_clock::time_point InboxTime;
 
-    bool IsNew = true;
     mutable bool ReadPending = false;
+    // In the readable list of the server, or deferred to the next tick
+    bool ReadQueued = false;
     mutable bool ClosePending = false;
+    // The I/O thread already closed the socket
+    bool Closed = false;
 };
 /// <summary>
 /// A pointer to a connection.
-/// Do not store this pointer, it may become invalid.
+/// Do not store this pointer, it becomes invalid after CheckNetwork or CleanClosedConnections. Store a ConnectionHandle instead.
 /// </summary>
 typedef Connection* ClientPtr;
 
 /// <summary>
 /// TCP/IP server.
+/// The sockets are served by I/O threads, the connections are only used from the thread that calls CheckNetwork.
 /// </summary>
 class TcpIpServer final
 {
@@ -48,27 +107,35 @@ public:
     /// Open server and start listening.
     /// </summary>
     /// <param name="port">Port number to listen.</param>
-    void Open(unsigned int port);
+    /// <param name="ioThreadCount">Number of threads doing the network work, connections are spread between them.</param>
+    void Open(unsigned int port, unsigned int ioThreadCount = 1);
     /// <summary>
     /// Stop listening and close all connections.
     /// </summary>
     void Close();
 
     /// <summary>
-    /// Accept new connections and check all clients for pending data and close requests.
+    /// Collect what the I/O threads have posted: new connections, received messages and closed connections.
+    /// Rethrows the errors of the I/O threads.
     /// </summary>
     void CheckNetwork();
     /// <summary>
-    /// Find a client that has just connected.
+    /// Find a client that has just connected, in the order they connected.
     /// </summary>
     /// <returns>A client that is new, or nullptr.</returns>
     ClientPtr FindNewClient();
     /// <summary>
-    /// Find a client that has pending data.
+    /// Find a client that has pending data. Each client is returned once per tick (CheckNetwork call), in turn.
+    /// A client with more messages than the budget is served again on the next tick.
     /// </summary>
     /// <returns>A client that has pending data, or nullptr.</returns>
     ClientPtr FindClientWithPendingData();
     /// <summary>
+    /// True when clients still have messages left over by the budget.
+    /// The owner should not wait for network events before the next tick then.
+    /// </summary>
+    bool HasDeferredData() const { return !m_DeferredConnections.empty() || m_LastServed != INVALID_CONNECTION; }
+    /// <summary>
     /// Close all clients that are marked for closing.
     /// </summary>
     /// <param name="lastCallback">A callback that will be called for each client that is closed.</param>
@@ -78,17 +145,55 @@ public:
     /// <summary>
     /// Return all connections.
     /// </summary>
-    const std::vector<Connection>& GetConnections() { return m_Connections; }
+    const SlotMap<Connection>& GetConnections() { return m_Connections; }
     /// <summary>
-    /// Return a connection by its name.
+    /// Return the connection of a handle, or nullptr if it was cleaned.
     /// </summary>
-    ClientPtr GetClientByName(const std::string& name);
+    ClientPtr GetClient(ConnectionHandle handle) { return m_Connections.Get(handle); }
+
+    /// <summary>
+    /// Change the outbound queue limits. Must be called before Open.
+    /// </summary>
+    void SetOutboundSettings(const OutboundSettings& settings) { m_OutboundSettings = settings; }
+    /// <summary>
+    /// Set a backend to wake up whenever the I/O threads have posted something for CheckNetwork,
+    /// so the owner can sleep in its poll instead of calling CheckNetwork in a loop. Must be called before Open.
+    /// </summary>
+    void SetWakeTarget(IReadinessBackend* wakeTarget) { m_WakeTarget = wakeTarget; }
+    /// <summary>
+    /// Set how many messages Receive returns per client and per tick, so a chatty client can't starve the others.
+    /// 0 means no limit.
+    /// </summary>
+    void SetMessageBudget(size_t messagesPerTick) { m_MessageBudget = messagesPerTick; }
 
 private:
+    friend struct Connection;
+
+    /// <summary>
+    /// Put the client returned by the last FindClientWithPendingData in the list of the next tick, if it has messages left.
+    /// </summary>
+    void DeferLastServed();
 
     WSADATA m_WsaData;
     SOCKET m_ListenSocket;
-    WSAEVENT m_AcceptEvent;
 
-    std::vector<Connection> m_Connections;
+    OutboundSettings m_OutboundSettings;
+    IReadinessBackend* m_WakeTarget;
+    std::vector<IoThread*> m_IoThreads;
+    // Filled by the I/O threads
+    MailBox<NetworkEvent> m_Events;
+    std::vector<NetworkEvent> m_ReceivedEvents;
+
+    SlotMap<Connection> m_Connections;
+    // HashMap <Connection id (I/O threads), Handle (game thread)>
+    std::unordered_map<ConnectionId, ConnectionHandle> m_ConnectionHandles;
+
+    // Ready lists, so finding a client costs nothing when nobody is ready. They can hold handles of cleaned connections.
+    std::deque<ConnectionHandle> m_NewConnections;
+    std::deque<ConnectionHandle> m_ReadableConnections;
+    // Clients with messages left over by the budget, served first on the next tick
+    std::deque<ConnectionHandle> m_DeferredConnections;
+    std::vector<ConnectionHandle> m_ClosingConnections;
+    ConnectionHandle m_LastServed = INVALID_CONNECTION;
+    size_t m_MessageBudget = 0;
 };
@@ -0,0 +1,132 @@
+#include "WsaPollBackend.h"
+#ifdef _WIN32
+using enum TcpIp::ErrorCode;
+
+// Convert our flags to the POLLXXX flags used by WSAPoll. Errors and hang ups are always reported.
+static SHORT ToPollEvents(unsigned int events)
+{
+    SHORT pollEvents = 0;
+    if (events & (READY_ACCEPT | READY_READ)) pollEvents |= POLLRDNORM;
+    if (events & READY_WRITE) pollEvents |= POLLWRNORM;
+    return pollEvents;
+}
+
+static void SetNonBlocking(SOCKET socket)
+{
+    // Same behavior as WSAEventSelect
+    u_long mode = 1;
+    if (ioctlsocket(socket, FIONBIO, &mode) == SOCKET_ERROR)
+        throw TcpIp::TcpIpException::Create(EVENT_SelectFailed, TCP_IP_WSA_ERROR);
+}
+
+WsaPollBackend::WsaPollBackend()
+    : m_PollFds()
+    , m_Watched()
+    , m_WakeSocket(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP))
+{
+    if (m_WakeSocket == INVALID_SOCKET)
+        throw TcpIp::TcpIpException::Create(EVENT_CreateFailed, TCP_IP_WSA_ERROR);
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0; // Let the system choose a port
+
+    int addressLength = sizeof(address);
+    if (bind(m_WakeSocket, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR
+        || getsockname(m_WakeSocket, (sockaddr*)&address, &addressLength) == SOCKET_ERROR
+        || connect(m_WakeSocket, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR)
+    {
+        closesocket(m_WakeSocket);
+        throw TcpIp::TcpIpException::Create(EVENT_CreateFailed, TCP_IP_WSA_ERROR);
+    }
+    SetNonBlocking(m_WakeSocket);
+
+    // No ReadyFlag is watched for it, so Poll never reports it as a socket
+    m_PollFds.push_back({m_WakeSocket, POLLRDNORM, 0});
+    m_Watched.push_back(READY_NONE);
+}
+
+WsaPollBackend::~WsaPollBackend()
+{
+    closesocket(m_WakeSocket);
+}
+
+void WsaPollBackend::Watch(SOCKET socket, unsigned int events)
+{
+    for (size_t i = 1; i < m_PollFds.size(); ++i)
+    {
+        if (m_PollFds[i].fd != socket) continue;
+
+        // Already watched, only change the events
+        m_PollFds[i].events = ToPollEvents(events);
+        m_Watched[i] = events;
+        return;
+    }
+
+    SetNonBlocking(socket);
+    m_PollFds.push_back({socket, ToPollEvents(events), 0});
+    m_Watched.push_back(events);
+}
+
+void WsaPollBackend::Unwatch(SOCKET socket)
+{
+    for (size_t i = 1; i < m_PollFds.size(); ++i)
+    {
+        if (m_PollFds[i].fd != socket) continue;
+
+        // Order does not matter, swap with the last one to avoid moving the whole vector
+        m_PollFds[i] = m_PollFds.back();
+        m_PollFds.pop_back();
+        m_Watched[i] = m_Watched.back();
+        m_Watched.pop_back();
+        return;
+    }
+}
+
+void WsaPollBackend::Poll(std::vector<ReadyEvent>& ready, int timeoutMs)
+{
+    ready.clear();
+
+    int count = WSAPoll(m_PollFds.data(), static_cast<ULONG>(m_PollFds.size()), timeoutMs);
+    if (count == SOCKET_ERROR)
+        throw TcpIp::TcpIpException::Create(EVENT_EnumFailed, TCP_IP_WSA_ERROR);
+    if (count == 0)
+        return;
+
+    if (m_PollFds[0].revents & POLLRDNORM)
+    {
+        // Empty the wake socket, the wake up is done
+        char buffer[64];
+        while (recv(m_WakeSocket, buffer, sizeof(buffer), 0) > 0) {}
+    }
+
+    for (size_t i = 1; i < m_PollFds.size(); ++i)
+    {
+        const SHORT revents = m_PollFds[i].revents;
+        if (revents == 0) continue;
+
+        const unsigned int watched = m_Watched[i];
+        unsigned int flags = READY_NONE;
+        if (revents & POLLRDNORM)
+            flags |= (watched & READY_ACCEPT) ? READY_ACCEPT : READY_READ;
+        // An error is only about this socket: it is reported as closed, what is left in it is still read first
+        if (revents & (POLLHUP | POLLERR | POLLNVAL))
+            flags |= (watched & READY_ACCEPT) ? READY_ACCEPT : READY_CLOSE | READY_READ;
+        if (revents & POLLWRNORM)
+            flags |= READY_WRITE;
+
+        flags &= watched;
+        if (flags != READY_NONE)
+            ready.push_back({m_PollFds[i].fd, flags});
+    }
+}
+
+void WsaPollBackend::Wake()
+{
+    const char one = 1;
+    if (send(m_WakeSocket, &one, sizeof(one), 0) == SOCKET_ERROR && WSAGetLastError() != WSAEWOULDBLOCK) // WSAEWOULDBLOCK: wake ups are already pending
+        throw TcpIp::TcpIpException::Create(EVENT_SelectFailed, TCP_IP_WSA_ERROR);
+}
+
+#endif // _WIN32
@@ -0,0 +1,32 @@
+#pragma once
+#ifdef _WIN32
+#include "ReadinessBackend.h"
+
+/// <summary>
+/// Readiness backend based on WSAPoll (level-triggered).
+/// Unlike WSAWaitForMultipleEvents, there is no limit on the number of sockets it waits on.
+/// Every watched socket is still passed to each poll, so a poll costs O(watched sockets).
+/// </summary>
+class WsaPollBackend final : public IReadinessBackend
+{
+public:
+    WsaPollBackend();
+    ~WsaPollBackend() override;
+    WsaPollBackend(const WsaPollBackend&) = delete;
+    WsaPollBackend& operator=(const WsaPollBackend&) = delete;
+
+    void Watch(SOCKET socket, unsigned int events) override;
+    void Unwatch(SOCKET socket) override;
+    void Poll(std::vector<ReadyEvent>& ready, int timeoutMs) override;
+    void Wake() override;
+
+private:
+    // The first one is the wake socket, then the watched sockets
+    std::vector<WSAPOLLFD> m_PollFds;
+    // ReadyFlags watched for each entry of m_PollFds
+    std::vector<unsigned int> m_Watched;
+    // Loopback UDP socket connected to itself, Wake() sends it a byte
+    SOCKET m_WakeSocket;
+};
+
+#endif // _WIN32
@@ -0,0 +1,58 @@
+#include "CellMask.h"
+
+namespace TicTacToe
+{
+    CellMask::CellMask(size_t cellCount)
+    {
+        if (cellCount > WORD_BITS)
+            m_Words.resize((cellCount + WORD_BITS - 1) / WORD_BITS, 0);
+    }
+
+    void CellMask::Clear()
+    {
+        m_Word = 0;
+        for (uint64_t& word : m_Words)
+        {
+            word = 0;
+        }
+    }
+
+    size_t CellMask::Count() const
+    {
+        if (m_Words.empty())
+            return std::popcount(m_Word);
+
+        size_t count = 0;
+        for (const uint64_t word : m_Words)
+        {
+            count += std::popcount(word);
+        }
+        return count;
+    }
+
+    bool CellMask::Contains(const CellMask& other) const
+    {
+        if (m_Words.empty())
+            return (m_Word & other.m_Word) == other.m_Word;
+
+        for (size_t i = 0; i < m_Words.size(); i++)
+        {
+            if ((m_Words[i] & other.m_Words[i]) != other.m_Words[i])
+                return false;
+        }
+        return true;
+    }
+
+    size_t CellMask::CountCommon(const CellMask& other) const
+    {
+        if (m_Words.empty())
+            return std::popcount(m_Word & other.m_Word);
+
+        size_t count = 0;
+        for (size_t i = 0; i < m_Words.size(); i++)
+        {
+            count += std::popcount(m_Words[i] & other.m_Words[i]);
+        }
+        return count;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TicTacToe
+{
+    /// <summary>
+    /// A set of cells of a board, one bit per cell. (Bit `row * width + column`)
+    /// Boards up to 64 cells fit in one word, larger boards use as many words as they need.
+    /// </summary>
+    class CellMask
+    {
+    public:
+        static constexpr size_t WORD_BITS = 64;
+
+        CellMask() = default;
+        /// <summary>
+        /// Creates an empty mask able to hold the given number of cells.
+        /// </summary>
+        explicit CellMask(size_t cellCount);
+
+        bool Test(size_t cell) const { return (GetWord(cell) >> (cell % WORD_BITS)) & 1; }
+        void Set(size_t cell) { GetWord(cell) |= uint64_t(1) << (cell % WORD_BITS); }
+        void Reset(size_t cell) { GetWord(cell) &= ~(uint64_t(1) << (cell % WORD_BITS)); }
+        /// <summary>
+        /// Removes every cell, keeping the size.
+        /// </summary>
+        void Clear();
+
+        /// <summary>
+        /// Returns the number of cells in the mask.
+        /// </summary>
+        size_t Count() const;
+        /// <summary>
+        /// Returns true if every cell of `other` is in this mask.
+        /// </summary>
+        bool Contains(const CellMask& other) const;
+        /// <summary>
+        /// Returns the number of cells in both masks.
+        /// </summary>
+        size_t CountCommon(const CellMask& other) const;
+
+    private:
+        uint64_t& GetWord(size_t cell) { return m_Words.empty() ? m_Word : m_Words[cell / WORD_BITS]; }
+        uint64_t GetWord(size_t cell) const { return m_Words.empty() ? m_Word : m_Words[cell / WORD_BITS]; }
+
+        // Boards up to 64 cells, no allocation
+        uint64_t m_Word = 0;
+        // Larger boards, m_Word is unused then
+        std::vector<uint64_t> m_Words;
+    };
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include "TicTacToe.h"
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace TicTacToe
+{
+    /// <summary>
+    /// The win tables of a FixedBoard, built at compile time.
+    /// </summary>
+    namespace FixedBoardTables
+    {
+        // Right, down, down-right and down-left, as {row step, column step}
+        constexpr int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+        /// <summary>
+        /// Calls `onLine` with the mask of every line of K cells of a W x H board.
+        /// </summary>
+        template <size_t W, size_t H, unsigned int K, typename OnLine>
+        constexpr void ForEachLine(OnLine&& onLine)
+        {
+            const int width = static_cast<int>(W), height = static_cast<int>(H), goal = static_cast<int>(K);
+            for (const auto& [rowStep, colStep] : DIRECTIONS)
+            {
+                for (int row = 0; row < height; row++)
+                {
+                    for (int col = 0; col < width; col++)
+                    {
+                        // The last cell of the line has to be on the board too
+                        const int lastRow = row + rowStep * (goal - 1);
+                        const int lastCol = col + colStep * (goal - 1);
+                        if (lastRow >= height || lastCol < 0 || lastCol >= width)
+                            continue;
+
+                        uint64_t line = 0;
+                        for (int i = 0; i < goal; i++)
+                        {
+                            line |= uint64_t(1) << ((row + rowStep * i) * width + col + colStep * i);
+                        }
+                        onLine(line);
+                    }
+                }
+            }
+        }
+
+        template <size_t W, size_t H, unsigned int K>
+        constexpr size_t CountLines()
+        {
+            size_t count = 0;
+            ForEachLine<W, H, K>([&](uint64_t) { count++; });
+            return count;
+        }
+
+        template <size_t W, size_t H, unsigned int K>
+        constexpr auto MakeLines()
+        {
+            std::array<uint64_t, CountLines<W, H, K>()> lines{};
+            size_t count = 0;
+            ForEachLine<W, H, K>([&](uint64_t line) { lines[count++] = line; });
+            return lines;
+        }
+
+        /// <summary>
+        /// The lines going through one cell. (At most K per direction)
+        /// </summary>
+        template <unsigned int K>
+        struct CellLines
+        {
+            std::array<uint64_t, 4 * K> Lines{};
+            size_t Count = 0;
+        };
+
+        template <size_t W, size_t H, unsigned int K>
+        constexpr auto MakeCellLines()
+        {
+            std::array<CellLines<K>, W * H> cells{};
+            ForEachLine<W, H, K>([&](uint64_t line)
+            {
+                for (size_t cell = 0; cell < W * H; cell++)
+                {
+                    if (line & (uint64_t(1) << cell))
+                        cells[cell].Lines[cells[cell].Count++] = line;
+                }
+            });
+            return cells;
+        }
+    }
+
+    /// <summary>
+    /// A board whose size is known at compile time: W columns, H rows, K pieces in a row to win.
+    /// Each side is one word, and the winning lines (all of them, and the ones through each cell) are tables
+    /// built at compile time: a move is checked with a few mask compares, without any division or loop over the board.
+    /// </summary>
+    template <size_t W, size_t H, unsigned int K>
+    class FixedBoard final : public BoardModel
+    {
+        static_assert(W * H <= 64, "A fixed board holds a side in one 64 bits word, use a DynamicBoard");
+        static_assert(K >= 1 && (K <= W || K <= H), "The alignment goal must fit on the board");
+
+    public:
+        static constexpr size_t SIZE = W * H;
+        static constexpr auto LINES = FixedBoardTables::MakeLines<W, H, K>();
+        static constexpr auto CELL_LINES = FixedBoardTables::MakeCellLines<W, H, K>();
+
+        Piece GetPiece(size_t cell) const override
+        {
+            const uint64_t bit = uint64_t(1) << cell;
+            if (m_Pieces[0] & bit)
+                return Piece::X;
+            if (m_Pieces[1] & bit)
+                return Piece::O;
+            return Piece::Empty;
+        }
+
+        void SetPiece(size_t cell, Piece piece) override
+        {
+            const uint64_t bit = uint64_t(1) << cell;
+            m_Pieces[0] &= ~bit;
+            m_Pieces[1] &= ~bit;
+            if (piece != Piece::Empty)
+                m_Pieces[static_cast<unsigned int>(piece) - 1] |= bit;
+        }
+
+        bool IsFull() const override { return std::popcount(m_Pieces[0] | m_Pieces[1]) == SIZE; }
+
+        Piece IsThereAWinner() const override
+        {
+            for (const uint64_t line : LINES)
+            {
+                if ((m_Pieces[0] & line) == line)
+                    return Piece::X;
+                if ((m_Pieces[1] & line) == line)
+                    return Piece::O;
+            }
+            return Piece::Empty;
+        }
+
+        Piece CheckWinAt(size_t cell) const override
+        {
+            const Piece piece = GetPiece(cell);
+            if (piece == Piece::Empty)
+                return Piece::Empty;
+
+            const uint64_t side = m_Pieces[static_cast<unsigned int>(piece) - 1];
+            const auto& cellLines = CELL_LINES[cell];
+            for (size_t i = 0; i < cellLines.Count; i++)
+            {
+                if ((side & cellLines.Lines[i]) == cellLines.Lines[i])
+                    return piece;
+            }
+            return Piece::Empty;
+        }
+
+        LineScan ScanLines() const override
+        {
+            // Few enough lines to look at each
+            LineScan scan;
+            for (const uint64_t line : LINES)
+            {
+                const unsigned int pieces[2] = {
+                    static_cast<unsigned int>(std::popcount(m_Pieces[0] & line)),
+                    static_cast<unsigned int>(std::popcount(m_Pieces[1] & line))};
+                for (unsigned int side = 0; side < 2; side++)
+                {
+                    if (pieces[side] == K)
+                        scan.HasLine[side] = true;
+                    else if (pieces[side] + 1 == K && pieces[1 - side] == 0)
+                        scan.Threats[side]++;
+                }
+            }
+            return scan;
+        }
+
+        void SetEmpty() override
+        {
+            m_Pieces[0] = 0;
+            m_Pieces[1] = 0;
+        }
+
+        std::unique_ptr<BoardModel> Clone() const override { return std::make_unique<FixedBoard>(*this); }
+
+    private:
+        // The cells of X, then of O
+        uint64_t m_Pieces[2] = {};
+    };
+
+    // The size of the CLASSIC and FAST modes
+    typedef FixedBoard<DEFAULT_BOARD_ARGS> ClassicBoard;
+}
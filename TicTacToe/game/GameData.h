@@ -2,25 +2,30 @@
 #include <vector>
 #include <string>
 #include "TicTacToe.h"
-#include "../tcp-ip/ISerializable.h"
+#include "../tcp-ip/Fields.h"
 
-struct PlayerMove : ISerializable
+struct PlayerMove
 {
+    PlayerMove() = default;
     PlayerMove(const std::string& playerName, const TicTacToe::Piece piece, const unsigned int cell) : PlayerName(playerName), PlayerPiece(piece), BoardCell(cell) {}
-    PlayerMove(const Json& j) : PlayerName(j["PlayerName"]), PlayerPiece(j["PlayerPiece"]), BoardCell(j["BoardCell"]) {}
-
-    Json Serialize() override;
 
     std::string PlayerName;
-    TicTacToe::Piece PlayerPiece;
-    unsigned int BoardCell;
+    TicTacToe::Piece PlayerPiece = TicTacToe::Piece::Empty;
+    unsigned int BoardCell = 0;
+
+    static constexpr auto GetFields()
+    {
+        return std::make_tuple(
+            MakeField("PlayerName", &PlayerMove::PlayerName),
+            MakeField("PlayerPiece", &PlayerMove::PlayerPiece),
+            MakeField("BoardCell", &PlayerMove::BoardCell));
+    }
 };
 
-struct GameData : ISerializable
+struct GameData
 {
     GameData() = default;
     GameData(const std::vector<PlayerMove>&, const std::string&, const std::string&);
-    GameData(const Json& j);
 
     std::string GetWinnerName() const { return AllMoves.back().PlayerName; }
     TicTacToe::Piece GetWinnerPiece() const { return AllMoves.back().PlayerPiece; }
@@ -32,7 +37,14 @@ struct GameData : ISerializable
     const PlayerMove& GetMove(unsigned int moveIndex) const { return AllMoves.at(moveIndex); }
     size_t GetMovesSize() const { return AllMoves.size(); }
 
-    Json Serialize() override;
+    static constexpr auto GetFields()
+    {
+        return std::make_tuple(
+            MakeField("AllMoves", &GameData::AllMoves),
+            MakeField("PlayerX", &GameData::PlayerX),
+            MakeField("PlayerO", &GameData::PlayerO),
+            MakeField("DateTime", &GameData::DateTime));
+    }
 
 private:
 
@@ -0,0 +1,181 @@
+#include "LineScanKernel.h"
+#include <bit>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define LINE_SCAN_X64
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace TicTacToe
+{
+    namespace
+    {
+        /// <summary>
+        /// Four rows in a 64 bits integer. Shifts are masked so no bit moves to another row.
+        /// </summary>
+        struct ScalarLanes
+        {
+            using Vector = uint64_t;
+            static constexpr size_t LANES = 4;
+            static constexpr uint64_t LANE_ONES = 0x0001000100010001;
+
+            static Vector Load(const uint16_t* rows)
+            {
+                Vector value;
+                std::memcpy(&value, rows, sizeof(value));
+                return value;
+            }
+            static Vector Zero() { return 0; }
+            static Vector Ones() { return ~uint64_t(0); }
+            static Vector And(Vector a, Vector b) { return a & b; }
+            static Vector Or(Vector a, Vector b) { return a | b; }
+            static Vector AndNot(Vector a, Vector b) { return a & ~b; }
+            static Vector Shift(Vector value, int shift)
+            {
+                if (shift >= 0)
+                    return (value >> shift) & (LANE_ONES * (0xFFFF >> shift));
+                return (value << -shift) & (LANE_ONES * ((0xFFFF << -shift) & 0xFFFF));
+            }
+            static bool Any(Vector value) { return value != 0; }
+            static unsigned int Count(Vector value) { return std::popcount(value); }
+        };
+
+#ifdef LINE_SCAN_X64
+        /// <summary>
+        /// Eight rows in a SSE2 register. (Always available on x64)
+        /// </summary>
+        struct Sse2Lanes
+        {
+            using Vector = __m128i;
+            static constexpr size_t LANES = 8;
+
+            static Vector Load(const uint16_t* rows) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows)); }
+            static Vector Zero() { return _mm_setzero_si128(); }
+            static Vector Ones() { return _mm_set1_epi32(-1); }
+            static Vector And(Vector a, Vector b) { return _mm_and_si128(a, b); }
+            static Vector Or(Vector a, Vector b) { return _mm_or_si128(a, b); }
+            static Vector AndNot(Vector a, Vector b) { return _mm_andnot_si128(b, a); }
+            static Vector Shift(Vector value, int shift)
+            {
+                if (shift >= 0)
+                    return _mm_srl_epi16(value, _mm_cvtsi32_si128(shift));
+                return _mm_sll_epi16(value, _mm_cvtsi32_si128(-shift));
+            }
+            static bool Any(Vector value) { return _mm_movemask_epi8(_mm_cmpeq_epi8(value, _mm_setzero_si128())) != 0xFFFF; }
+            static unsigned int Count(Vector value)
+            {
+                uint64_t words[2];
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(words), value);
+                return std::popcount(words[0]) + std::popcount(words[1]);
+            }
+        };
+#endif
+
+        bool HasAvx2()
+        {
+#if defined(LINE_SCAN_X64) && defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+                return false;
+            __cpuid(info, 1);
+            // AVX, and the system saves the AVX registers
+            const bool osSavesAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+            __cpuidex(info, 7, 0);
+            return osSavesAvx && (info[1] & (1 << 5));
+#elif defined(LINE_SCAN_X64)
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+        }
+
+        using ScanFunction = LineScan(*)(const RowPlanes&);
+
+        ScanFunction GetScanFunction(ScanKernel kernel)
+        {
+            switch (kernel)
+            {
+#ifdef LINE_SCAN_X64
+            case ScanKernel::Avx2: return ScanRowsAvx2;
+            case ScanKernel::Sse2: return ScanRowsSse2;
+#endif
+            default: return ScanRowsScalar;
+            }
+        }
+
+        // Looked up once, the processor doesn't change
+        const ScanKernel s_BestScanKernel = HasAvx2() ? ScanKernel::Avx2
+#ifdef LINE_SCAN_X64
+            : ScanKernel::Sse2;
+#else
+            : ScanKernel::Scalar;
+#endif
+    }
+
+    LineScan ScanRowsScalar(const RowPlanes& planes)
+    {
+        return ScanRows<ScalarLanes>(planes);
+    }
+
+#ifdef LINE_SCAN_X64
+    LineScan ScanRowsSse2(const RowPlanes& planes)
+    {
+        return ScanRows<Sse2Lanes>(planes);
+    }
+#endif
+
+    ScanKernel GetBestScanKernel()
+    {
+        return s_BestScanKernel;
+    }
+
+    bool IsScanKernelSupported(ScanKernel kernel)
+    {
+        return static_cast<unsigned int>(kernel) <= static_cast<unsigned int>(s_BestScanKernel);
+    }
+
+    RowBitboard::RowBitboard(size_t width, size_t height, unsigned int alignementGoal)
+        : m_Height(height)
+        , m_AlignementGoal(alignementGoal)
+        , m_RowMask(static_cast<uint16_t>((1u << width) - 1))
+    {
+        // The kernels read up to 16 rows at once, and a window reaches goal - 1 rows lower
+        const size_t paddedHeight = (height + 15) / 16 * 16 + alignementGoal;
+        for (auto& rows : m_Rows)
+        {
+            rows.assign(paddedHeight, 0);
+        }
+        Clear();
+    }
+
+    void RowBitboard::Set(size_t row, size_t col, unsigned int piece)
+    {
+        const uint16_t bit = static_cast<uint16_t>(1u << col);
+        for (auto& rows : m_Rows)
+        {
+            rows[row] &= ~bit;
+        }
+        m_Rows[piece == 0 ? 2 : piece - 1][row] |= bit;
+    }
+
+    void RowBitboard::Clear()
+    {
+        for (size_t row = 0; row < m_Height; row++)
+        {
+            m_Rows[0][row] = 0;
+            m_Rows[1][row] = 0;
+            m_Rows[2][row] = m_RowMask;
+        }
+    }
+
+    LineScan RowBitboard::Scan(ScanKernel kernel) const
+    {
+        const RowPlanes planes = {{m_Rows[0].data(), m_Rows[1].data(), m_Rows[2].data()}, m_Height, m_AlignementGoal};
+        return GetScanFunction(kernel)(planes);
+    }
+}
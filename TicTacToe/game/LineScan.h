@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TicTacToe
+{
+    /// <summary>
+    /// What a scan of every line of a board found, per side. (X, then O)
+    /// </summary>
+    struct LineScan
+    {
+        // The side has aligned the goal
+        bool HasLine[2] = {};
+        // Windows of the goal length holding goal - 1 pieces of the side and one empty cell: one move from a win
+        unsigned int Threats[2] = {};
+    };
+
+    /// <summary>
+    /// The instruction sets a scan can run with, from the slowest.
+    /// </summary>
+    enum class ScanKernel : unsigned int
+    {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    /// <summary>
+    /// Returns the fastest kernel the processor supports, the one Scan uses.
+    /// </summary>
+    ScanKernel GetBestScanKernel();
+    bool IsScanKernelSupported(ScanKernel kernel);
+
+    /// <summary>
+    /// The cells of a board up to 16 columns wide, one 16 bits word per row and per kind of cell: X, O and empty.
+    /// Every row, column and diagonal is scanned at once by shifting and and-ing whole rows, several rows per instruction.
+    /// </summary>
+    class RowBitboard
+    {
+    public:
+        static constexpr size_t MAX_WIDTH = 16;
+        static constexpr unsigned int MAX_GOAL = 16;
+
+        /// <summary>
+        /// Returns true if a board of this size can be held and scanned.
+        /// </summary>
+        static bool Fits(size_t width, unsigned int alignementGoal) { return width <= MAX_WIDTH && alignementGoal >= 1 && alignementGoal <= MAX_GOAL; }
+
+        RowBitboard() = default;
+        /// <summary>
+        /// Creates an empty board. The size must fit, see Fits.
+        /// </summary>
+        RowBitboard(size_t width, size_t height, unsigned int alignementGoal);
+
+        /// <summary>
+        /// Puts a piece in a cell. (0 for empty, 1 for X, 2 for O)
+        /// </summary>
+        void Set(size_t row, size_t col, unsigned int piece);
+        void Clear();
+
+        LineScan Scan() const { return Scan(GetBestScanKernel()); }
+        /// <summary>
+        /// Scans with a given kernel, which must be supported.
+        /// </summary>
+        LineScan Scan(ScanKernel kernel) const;
+
+    private:
+        size_t m_Height = 0;
+        unsigned int m_AlignementGoal = 0;
+        // The row mask of the real cells
+        uint16_t m_RowMask = 0;
+        // X, O and empty cells. Followed by rows holding nothing, so a scan can read past the last row.
+        std::vector<uint16_t> m_Rows[3];
+    };
+}
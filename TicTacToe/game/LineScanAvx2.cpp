@@ -0,0 +1,45 @@
+// Compiled with AVX2 enabled, only called when the processor supports it. (See LineScan.cpp)
+#include "LineScanKernel.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+
+namespace TicTacToe
+{
+    namespace
+    {
+        /// <summary>
+        /// Sixteen rows in an AVX2 register: a whole 15x15 board in one.
+        /// </summary>
+        struct Avx2Lanes
+        {
+            using Vector = __m256i;
+            static constexpr size_t LANES = 16;
+
+            static Vector Load(const uint16_t* rows) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows)); }
+            static Vector Zero() { return _mm256_setzero_si256(); }
+            static Vector Ones() { return _mm256_set1_epi32(-1); }
+            static Vector And(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+            static Vector Or(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+            static Vector AndNot(Vector a, Vector b) { return _mm256_andnot_si256(b, a); }
+            static Vector Shift(Vector value, int shift)
+            {
+                if (shift >= 0)
+                    return _mm256_srl_epi16(value, _mm_cvtsi32_si128(shift));
+                return _mm256_sll_epi16(value, _mm_cvtsi32_si128(-shift));
+            }
+            static bool Any(Vector value) { return !_mm256_testz_si256(value, value); }
+            static unsigned int Count(Vector value)
+            {
+                return static_cast<unsigned int>(_mm_popcnt_u64(_mm256_extract_epi64(value, 0)) + _mm_popcnt_u64(_mm256_extract_epi64(value, 1))
+                    + _mm_popcnt_u64(_mm256_extract_epi64(value, 2)) + _mm_popcnt_u64(_mm256_extract_epi64(value, 3)));
+            }
+        };
+    }
+
+    LineScan ScanRowsAvx2(const RowPlanes& planes)
+    {
+        return ScanRows<Avx2Lanes>(planes);
+    }
+}
+#endif
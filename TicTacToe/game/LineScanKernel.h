@@ -0,0 +1,88 @@
+#pragma once
+#include "LineScan.h"
+
+// The scan shared by every instruction set, included by the translation unit of each kernel.
+// Nothing from the standard library is used here: the AVX2 unit is compiled for AVX2,
+// and an inline function it instantiated could be picked by the linker for the other units.
+
+namespace TicTacToe
+{
+    /// <summary>
+    /// The rows of a RowBitboard, as read by a kernel.
+    /// </summary>
+    struct RowPlanes
+    {
+        // X, O and empty, readable up to the height rounded to 16 rows, plus the goal
+        const uint16_t* Rows[3];
+        size_t Height;
+        unsigned int AlignementGoal;
+    };
+
+    LineScan ScanRowsScalar(const RowPlanes& planes);
+    LineScan ScanRowsSse2(const RowPlanes& planes);
+    LineScan ScanRowsAvx2(const RowPlanes& planes);
+
+    /// <summary>
+    /// Scans `Lanes::LANES` rows at a time. Each lane is a row, and bit c of a lane the window starting at column c:
+    /// the i-th cell of a window is brought in place by reading i rows lower and shifting by i columns.
+    /// `Lanes` provides the vector type and its operations.
+    /// </summary>
+    template <typename Lanes>
+    LineScan ScanRows(const RowPlanes& planes)
+    {
+        using Vector = typename Lanes::Vector;
+
+        // {row step, column step}: right, down, down-right and down-left
+        constexpr int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+        const unsigned int goal = planes.AlignementGoal;
+
+        LineScan scan;
+        for (size_t row = 0; row < planes.Height; row += Lanes::LANES)
+        {
+            for (const auto& direction : DIRECTIONS)
+            {
+                // Per side: the i-th cell of the windows, windows of pieces up to i, windows without a piece of the other side
+                Vector pieces[2][RowBitboard::MAX_GOAL];
+                Vector prefix[2][RowBitboard::MAX_GOAL + 1];
+                Vector open[2];
+                for (unsigned int side = 0; side < 2; side++)
+                {
+                    prefix[side][0] = Lanes::Ones();
+                    open[side] = Lanes::Ones();
+                }
+
+                for (unsigned int i = 0; i < goal; i++)
+                {
+                    const size_t offset = row + direction[0] * i;
+                    const int shift = direction[1] * static_cast<int>(i);
+                    const Vector empty = Lanes::Shift(Lanes::Load(planes.Rows[2] + offset), shift);
+                    for (unsigned int side = 0; side < 2; side++)
+                    {
+                        pieces[side][i] = Lanes::Shift(Lanes::Load(planes.Rows[side] + offset), shift);
+                        prefix[side][i + 1] = Lanes::And(prefix[side][i], pieces[side][i]);
+                        open[side] = Lanes::And(open[side], Lanes::Or(pieces[side][i], empty));
+                    }
+                }
+
+                for (unsigned int side = 0; side < 2; side++)
+                {
+                    const Vector line = prefix[side][goal];
+                    if (Lanes::Any(line))
+                        scan.HasLine[side] = true;
+
+                    // Windows with every piece but at most one: the pieces before it and after it
+                    Vector suffix = Lanes::Ones();
+                    Vector allButOne = Lanes::Zero();
+                    for (unsigned int i = goal; i-- > 0;)
+                    {
+                        allButOne = Lanes::Or(allButOne, Lanes::And(prefix[side][i], suffix));
+                        suffix = Lanes::And(suffix, pieces[side][i]);
+                    }
+                    // The missing cell is empty, not the other side nor off the board
+                    scan.Threats[side] += Lanes::Count(Lanes::AndNot(Lanes::And(allButOne, open[side]), line));
+                }
+            }
+        }
+        return scan;
+    }
+}
@@ -1,5 +1,7 @@
 #include "Lobby.h"
 #include "IDGenerator.h"
+#include <algorithm>
+#include <stdexcept>
 
 Lobby::Lobby()
 {
@@ -9,11 +11,6 @@ Lobby::Lobby()
     Data.PlayerO = "";
 }
 
-LobbyData::LobbyData(const Json& j)
-    : ID(j["ID"]), GameMode(j["GameMode"]), PlayerX(j["PlayerX"]), PlayerO(j["PlayerO"])
-{
-}
-
 Lobby::Lobby(GameModeType gameModeType)
 {
     Data.ID = IDGenerator::GenerateLobbyID();
@@ -43,7 +40,7 @@ std::string& Lobby::GetOpponentName(const std::string& senderName)
     else if (Data.PlayerX == senderName)
         return Data.PlayerO;
 
-    throw std::exception("Player not found");
+    throw std::runtime_error("Player not found");
 }
 
 void Lobby::AddPlayerToLobby(const std::string& name)
@@ -72,6 +69,22 @@ void Lobby::RemovePlayerFromLobby(const std::string& name)
         Data.PlayerO = "";
         PlayerCount--;
     }
+    else
+    {
+        return;
+    }
+
+    // The game can't go on without both players
+    Turn = TicTacToe::Piece::Empty;
+}
+
+TicTacToe::Piece Lobby::GetPlayerPiece(const std::string& name) const
+{
+    if (!name.empty() && Data.PlayerX == name)
+        return TicTacToe::Piece::X;
+    if (!name.empty() && Data.PlayerO == name)
+        return TicTacToe::Piece::O;
+    return TicTacToe::Piece::Empty;
 }
 
 void Lobby::AddPlayerMove(const std::string& playerName, const TicTacToe::Piece piece, const unsigned int cell)
@@ -93,12 +106,21 @@ LobbyData::LobbyData(const int id, GameModeType gameMode, const std::string& pla
     PlayerO = playerO;
 }
 
-Json LobbyData::Serialize()
+void Lobby::Subscribe(uint64_t connection, MessageEncoding encoding, bool isPlayer)
+{
+    const auto it = std::find_if(Subscribers.begin(), Subscribers.end(),
+        [connection](const LobbySubscriber& subscriber) { return subscriber.Connection == connection; });
+    if (it != Subscribers.end())
+    {
+        it->Encoding = encoding;
+        it->IsPlayer = isPlayer;
+        return;
+    }
+
+    Subscribers.push_back({ connection, encoding, isPlayer });
+}
+
+void Lobby::Unsubscribe(uint64_t connection)
 {
-    Json j;
-    j["ID"] = ID;
-    j["GameMode"] = GameMode;
-    j["PlayerX"] = PlayerX;
-    j["PlayerO"] = PlayerO;
-    return j;
+    std::erase_if(Subscribers, [connection](const LobbySubscriber& subscriber) { return subscriber.Connection == connection; });
 }
@@ -1,21 +1,68 @@
 #pragma once
+#include <cstdint>
 #include <string>
-#include "../tcp-ip/ISerializable.h"
+#include <vector>
+#include "../tcp-ip/Message.h"
 #include "TicTacToe.h"
 #include "GameData.h"
 #include "GameMode.h"
 
-struct LobbyData : ISerializable
+struct LobbyData
 {
     LobbyData() = default;
-    LobbyData(const Json& j);
     LobbyData(const int id, GameModeType gameMode, const std::string& playerX, const std::string& playerO);
 
-    Json Serialize() override;
-
     int ID = -1;
-    GameModeType GameMode;
+    GameModeType GameMode = CLASSIC;
     std::string PlayerX, PlayerO;
+
+    static constexpr auto GetFields()
+    {
+        return std::make_tuple(
+            MakeField("ID", &LobbyData::ID),
+            MakeField("GameMode", &LobbyData::GameMode),
+            MakeField("PlayerX", &LobbyData::PlayerX),
+            MakeField("PlayerO", &LobbyData::PlayerO));
+    }
+};
+
+/// <summary>
+/// What happened to a lobby since the previous version of the lobby list.
+/// </summary>
+enum class LobbyChange : unsigned int
+{
+    Joined,
+    Left,
+    Created,
+    // Only the ID of the data is set
+    Closed,
+};
+
+/// <summary>
+/// One lobby of a lobby list delta, with its data after the change.
+/// </summary>
+struct LobbyDelta
+{
+    LobbyChange Change = LobbyChange::Joined;
+    LobbyData Data;
+
+    static constexpr auto GetFields()
+    {
+        return std::make_tuple(
+            MakeField("Change", &LobbyDelta::Change),
+            MakeField("Lobby", &LobbyDelta::Data));
+    }
+};
+
+/// <summary>
+/// A connection that receives the messages of a lobby: one of its players, or a spectator.
+/// </summary>
+struct LobbySubscriber
+{
+    // Handle of the connection on the server
+    uint64_t Connection = 0;
+    MessageEncoding Encoding = MessageEncoding::Json;
+    bool IsPlayer = false;
 };
 
 struct Lobby
@@ -35,9 +82,22 @@ struct Lobby
     bool IsInLobby(const std::string& name) const { return Data.PlayerX == name || Data.PlayerO == name; }
     bool IsLobbyFull() const {  return !Data.PlayerX.empty() && !Data.PlayerO.empty(); }
     bool IsLobbyEmpty() const { return Data.PlayerX.empty() && Data.PlayerO.empty(); }
+    TicTacToe::Piece GetPlayerPiece(const std::string& name) const;
+
+    /// <summary>
+    /// Add a connection to the audience of the lobby. A connection is only there once, subscribing it again updates it.
+    /// </summary>
+    void Subscribe(uint64_t connection, MessageEncoding encoding, bool isPlayer);
+    void Unsubscribe(uint64_t connection);
 
     unsigned int PlayerCount = 0;
     LobbyData Data;
     TicTacToe::Board Board;
     std::vector<PlayerMove> CurrentGame;
+    // Everyone the messages of the lobby are sent to, a broadcast only costs its own audience
+    std::vector<LobbySubscriber> Subscribers;
+    // Piece that has to play next, Empty while no game is running
+    TicTacToe::Piece Turn = TicTacToe::Piece::Empty;
+    // Seat of the server bot, Empty if two humans play
+    TicTacToe::Piece BotPiece = TicTacToe::Piece::Empty;
 };
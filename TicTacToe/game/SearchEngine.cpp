@@ -0,0 +1,300 @@
+#include "SearchEngine.h"
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+namespace TicTacToe
+{
+    // Above any score, alpha and beta start there
+    static constexpr int INFINITE_SCORE = SearchEngine::WIN_SCORE + 1;
+    // What a threat is worth, far below a win
+    static constexpr int THREAT_SCORE = 100;
+    // Boards of more cells only try the cells that near a piece
+    static constexpr size_t NEAR_MOVES_SIZE = 64;
+    static constexpr int NEAR_DISTANCE = 2;
+    // Checking the clock on every node would cost more than the nodes
+    static constexpr size_t NODES_PER_CLOCK_CHECK = 1024;
+    static constexpr unsigned int NO_MOVE = UINT16_MAX;
+
+    static Piece GetOpponent(Piece side)
+    {
+        return side == Piece::X ? Piece::O : Piece::X;
+    }
+
+    SearchEngine::SearchEngine(unsigned int tableBits)
+        : m_Table(size_t(1) << tableBits)
+        , m_TableMask((uint64_t(1) << tableBits) - 1)
+    {
+    }
+
+    SearchEngine::Result SearchEngine::FindBestMove(const Board& board, Piece side, std::chrono::milliseconds budget)
+    {
+        Prepare(board);
+        m_Deadline = std::chrono::steady_clock::now() + budget;
+        m_CanStop = false;
+        m_IsStopped = false;
+        m_Nodes = 0;
+
+        // One more ply per iteration: each one is ordered by the table and the history of the previous ones
+        Result result;
+        const size_t emptyCells = m_Size - m_Pieces;
+        for (unsigned int depth = 1; depth <= emptyCells; depth++)
+        {
+            const int score = Negamax(depth, 0, -INFINITE_SCORE, INFINITE_SCORE, side);
+            if (m_IsStopped)
+                break;
+
+            result.Cell = m_RootMove;
+            result.Score = score;
+            result.Depth = depth;
+            // Searched to the end of the game, or a forced win within reach
+            result.IsSolved = (depth == emptyCells && !m_OnlyNearMoves) || std::abs(score) >= WIN_SCORE - static_cast<int>(m_Size);
+            if (result.IsSolved)
+                break;
+
+            // The first ply gives a legal move, the time can stop the next ones
+            m_CanStop = true;
+        }
+
+        result.Nodes = m_Nodes;
+        return result;
+    }
+
+    void SearchEngine::Prepare(const Board& board)
+    {
+        m_Board = board;
+        if (board.GetWidth() != m_Width || board.GetHeight() != m_Height || board.GetAlignementGoal() != m_AlignementGoal)
+        {
+            m_Width = board.GetWidth();
+            m_Height = board.GetHeight();
+            m_Size = board.GetTotalSize();
+            m_AlignementGoal = board.GetAlignementGoal();
+            m_OnlyNearMoves = m_Size > NEAR_MOVES_SIZE;
+
+            // Same seed every time, the keys only have to be spread
+            std::mt19937_64 random(0x5EED);
+            m_Keys.resize(m_Size * 2);
+            for (uint64_t& key : m_Keys)
+            {
+                key = random();
+            }
+            m_SideKey = random();
+            // The positions of another size have other keys
+            std::fill(m_Table.begin(), m_Table.end(), Entry());
+
+            m_CenterOrder.resize(m_Size);
+            for (unsigned int cell = 0; cell < m_Size; cell++)
+            {
+                m_CenterOrder[cell] = cell;
+            }
+            // Distances doubled, so the center of an even board is a whole number
+            const auto distance = [this](unsigned int cell)
+            {
+                const long long row = 2 * static_cast<long long>(cell / m_Width) - static_cast<long long>(m_Height - 1);
+                const long long col = 2 * static_cast<long long>(cell % m_Width) - static_cast<long long>(m_Width - 1);
+                return row * row + col * col;
+            };
+            std::stable_sort(m_CenterOrder.begin(), m_CenterOrder.end(),
+                [&distance](unsigned int a, unsigned int b) { return distance(a) < distance(b); });
+
+            m_History.assign(m_Size, 0);
+            m_MoveLists.resize(m_Size + 1);
+        }
+        else
+        {
+            // Older cut-offs matter less
+            for (unsigned int& history : m_History)
+            {
+                history /= 2;
+            }
+        }
+
+        m_Hash = 0;
+        m_Pieces = 0;
+        m_NearPieces.assign(m_Size, 0);
+        for (unsigned int cell = 0; cell < m_Size; cell++)
+        {
+            const Piece piece = m_Board.GetPiece(cell);
+            if (piece == Piece::Empty)
+                continue;
+
+            // Played again on the copy, for the hash and the neighbours
+            m_Board.SetPiece(cell, Piece::Empty);
+            Play(cell, piece);
+        }
+    }
+
+    int SearchEngine::Negamax(unsigned int depth, unsigned int ply, int alpha, int beta, Piece side)
+    {
+        m_Nodes++;
+        if (IsTimeUp())
+            return 0;
+
+        // Nothing to search past the last empty cell
+        const size_t emptyCells = m_Size - m_Pieces;
+        if (depth > emptyCells)
+            depth = static_cast<unsigned int>(emptyCells);
+
+        // Either side can start a game, the same pieces can be on the board with either side to move
+        const uint64_t hash = side == Piece::O ? m_Hash ^ m_SideKey : m_Hash;
+        Entry& entry = m_Table[hash & m_TableMask];
+        unsigned int tableMove = NO_MOVE;
+        if (entry.Key == hash)
+        {
+            tableMove = entry.Move;
+            // The root always searches, it has to tell which move is the best
+            if (ply > 0 && entry.Depth >= depth)
+            {
+                if (entry.Kind == Bound::Exact
+                    || (entry.Kind == Bound::Lower && entry.Score >= beta)
+                    || (entry.Kind == Bound::Upper && entry.Score <= alpha))
+                    return entry.Score;
+            }
+        }
+
+        if (depth == 0)
+            return Evaluate(side);
+
+        std::vector<unsigned int>& moves = m_MoveLists[ply];
+        GenerateMoves(moves, tableMove);
+
+        const int originalAlpha = alpha;
+        int best = -INFINITE_SCORE;
+        unsigned int bestMove = moves.front();
+        for (const unsigned int cell : moves)
+        {
+            Play(cell, side);
+            int score;
+            if (m_Board.CheckWinAt(cell) != Piece::Empty)
+                score = WIN_SCORE - static_cast<int>(m_Pieces);
+            else if (m_Pieces == m_Size)
+                score = 0;
+            else
+                score = -Negamax(depth - 1, ply + 1, -beta, -alpha, GetOpponent(side));
+            Undo(cell, side);
+
+            if (m_IsStopped)
+                return 0;
+
+            if (score > best)
+            {
+                best = score;
+                bestMove = cell;
+            }
+            if (best > alpha)
+                alpha = best;
+            if (alpha >= beta)
+            {
+                m_History[cell] += depth * depth;
+                break;
+            }
+        }
+
+        if (ply == 0)
+            m_RootMove = bestMove;
+
+        // Win scores only depend on the pieces on the board, so they can be stored as they are
+        entry.Key = hash;
+        entry.Score = best;
+        entry.Move = static_cast<uint16_t>(bestMove);
+        entry.Depth = static_cast<uint8_t>(depth < UINT8_MAX ? depth : UINT8_MAX);
+        entry.Kind = best <= originalAlpha ? Bound::Upper : best >= beta ? Bound::Lower : Bound::Exact;
+        return best;
+    }
+
+    int SearchEngine::Evaluate(Piece side) const
+    {
+        const LineScan scan = m_Board.ScanLines();
+        const unsigned int own = static_cast<unsigned int>(side) - 1;
+        const unsigned int other = 1 - own;
+
+        // The side to move completes its threat
+        if (scan.Threats[own] > 0)
+            return WIN_SCORE - static_cast<int>(m_Pieces + 1);
+        return (static_cast<int>(scan.Threats[own]) - static_cast<int>(scan.Threats[other])) * THREAT_SCORE;
+    }
+
+    void SearchEngine::GenerateMoves(std::vector<unsigned int>& moves, unsigned int tableMove) const
+    {
+        moves.clear();
+        if (m_OnlyNearMoves && m_Pieces == 0)
+        {
+            moves.push_back(m_CenterOrder.front());
+            return;
+        }
+
+        for (const unsigned int cell : m_CenterOrder)
+        {
+            if (m_Board.GetPiece(cell) == Piece::Empty && (!m_OnlyNearMoves || m_NearPieces[cell] > 0))
+                moves.push_back(cell);
+        }
+
+        // By history, the center order breaks the ties (an insertion sort keeps it, and doesn't allocate)
+        for (size_t i = 1; i < moves.size(); i++)
+        {
+            const unsigned int cell = moves[i];
+            size_t j = i;
+            for (; j > 0 && m_History[moves[j - 1]] < m_History[cell]; j--)
+            {
+                moves[j] = moves[j - 1];
+            }
+            moves[j] = cell;
+        }
+
+        // The best move of a previous search of the position goes first
+        const auto it = std::find(moves.begin(), moves.end(), tableMove);
+        if (it != moves.end())
+            std::rotate(moves.begin(), it, it + 1);
+    }
+
+    void SearchEngine::Play(unsigned int cell, Piece side)
+    {
+        m_Board.SetPiece(cell, side);
+        m_Hash ^= m_Keys[cell * 2 + static_cast<unsigned int>(side) - 1];
+        m_Pieces++;
+
+        if (!m_OnlyNearMoves)
+            return;
+        const int row = static_cast<int>(cell / m_Width);
+        const int col = static_cast<int>(cell % m_Width);
+        for (int r = row - NEAR_DISTANCE; r <= row + NEAR_DISTANCE; r++)
+        {
+            for (int c = col - NEAR_DISTANCE; c <= col + NEAR_DISTANCE; c++)
+            {
+                if (r >= 0 && r < static_cast<int>(m_Height) && c >= 0 && c < static_cast<int>(m_Width))
+                    m_NearPieces[r * m_Width + c]++;
+            }
+        }
+    }
+
+    void SearchEngine::Undo(unsigned int cell, Piece side)
+    {
+        m_Board.SetPiece(cell, Piece::Empty);
+        m_Hash ^= m_Keys[cell * 2 + static_cast<unsigned int>(side) - 1];
+        m_Pieces--;
+
+        if (!m_OnlyNearMoves)
+            return;
+        const int row = static_cast<int>(cell / m_Width);
+        const int col = static_cast<int>(cell % m_Width);
+        for (int r = row - NEAR_DISTANCE; r <= row + NEAR_DISTANCE; r++)
+        {
+            for (int c = col - NEAR_DISTANCE; c <= col + NEAR_DISTANCE; c++)
+            {
+                if (r >= 0 && r < static_cast<int>(m_Height) && c >= 0 && c < static_cast<int>(m_Width))
+                    m_NearPieces[r * m_Width + c]--;
+            }
+        }
+    }
+
+    bool SearchEngine::IsTimeUp()
+    {
+        if (m_IsStopped)
+            return true;
+        if (!m_CanStop || m_Nodes % NODES_PER_CLOCK_CHECK != 0)
+            return false;
+
+        m_IsStopped = std::chrono::steady_clock::now() >= m_Deadline;
+        return m_IsStopped;
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include "TicTacToe.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace TicTacToe
+{
+    /// <summary>
+    /// Finds the best move of a position: negamax with alpha-beta pruning, deepened one ply at a time until the time runs out.
+    /// Positions are hashed with Zobrist keys into a transposition table of fixed size, kept from one search to the next.
+    /// Small boards are searched to the end (a 3x3 board in well under a millisecond), so the engine plays them perfectly.
+    /// Larger boards are searched as deep as the time allows, the leaves are evaluated by the threats of Board::ScanLines.
+    /// </summary>
+    class SearchEngine
+    {
+    public:
+        /// <summary>
+        /// The best move found, and what it is worth for the side that plays it.
+        /// </summary>
+        struct Result
+        {
+            unsigned int Cell = 0;
+            // Above 0 the side wins, below 0 it loses, 0 is a draw or an even position
+            int Score = 0;
+            // Plies searched by the last completed iteration
+            unsigned int Depth = 0;
+            // The score is the outcome of perfect play, not an estimate
+            bool IsSolved = false;
+            size_t Nodes = 0;
+        };
+
+        // A win is worth this minus the pieces on the board when it happens: sooner is better
+        static constexpr int WIN_SCORE = 1000000;
+
+        /// <summary>
+        /// Creates an engine with a transposition table of 2^tableBits entries. (16 bytes each)
+        /// </summary>
+        explicit SearchEngine(unsigned int tableBits = 18);
+
+        /// <summary>
+        /// Returns the best move of `side` on the board, which must have an empty cell and no winner.
+        /// The search stops at the time budget, at least one ply is always searched.
+        /// </summary>
+        Result FindBestMove(const Board& board, Piece side, std::chrono::milliseconds budget);
+
+    private:
+        enum class Bound : uint8_t
+        {
+            Exact,
+            // The score is at least the stored one (the search was cut off)
+            Lower,
+            // The score is at most the stored one (no move reached alpha)
+            Upper,
+        };
+
+        struct Entry
+        {
+            uint64_t Key = 0;
+            int Score = 0;
+            uint16_t Move = 0;
+            uint8_t Depth = 0;
+            Bound Kind = Bound::Exact;
+        };
+
+        /// <summary>
+        /// Sets the keys, the move ordering and the neighbours for the size of the board. The table is cleared on a new size.
+        /// </summary>
+        void Prepare(const Board& board);
+        int Negamax(unsigned int depth, unsigned int ply, int alpha, int beta, Piece side);
+        /// <summary>
+        /// Scores a position for the side to move, without searching further.
+        /// </summary>
+        int Evaluate(Piece side) const;
+        /// <summary>
+        /// Lists the moves of a node, the most promising first.
+        /// </summary>
+        void GenerateMoves(std::vector<unsigned int>& moves, unsigned int tableMove) const;
+        void Play(unsigned int cell, Piece side);
+        void Undo(unsigned int cell, Piece side);
+        bool IsTimeUp();
+
+        // Copy of the searched board, moves are played and undone on it
+        Board m_Board;
+        size_t m_Width = 0, m_Height = 0, m_Size = 0;
+        unsigned int m_AlignementGoal = 0;
+        size_t m_Pieces = 0;
+        // Large boards only look at the cells near a piece, the search can't be exact then
+        bool m_OnlyNearMoves = false;
+
+        // A random key per cell and per side, the hash of a position is the xor of the keys of its pieces
+        std::vector<uint64_t> m_Keys;
+        // Xor-ed to the hash when O is to move
+        uint64_t m_SideKey = 0;
+        uint64_t m_Hash = 0;
+        std::vector<Entry> m_Table;
+        uint64_t m_TableMask;
+
+        // The cells nearer to the center first, between moves of equal history
+        std::vector<unsigned int> m_CenterOrder;
+        // Moves that caused cut-offs, by cell. Kept across searches
+        std::vector<unsigned int> m_History;
+        // Pieces near each cell, for m_OnlyNearMoves
+        std::vector<unsigned int> m_NearPieces;
+        // One move list per ply, allocated once
+        std::vector<std::vector<unsigned int>> m_MoveLists;
+
+        std::chrono::steady_clock::time_point m_Deadline;
+        bool m_CanStop = false;
+        bool m_IsStopped = false;
+        size_t m_Nodes = 0;
+        unsigned int m_RootMove = 0;
+    };
+}
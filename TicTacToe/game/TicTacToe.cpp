@@ -1,6 +1,9 @@
 #include "TicTacToe.h"
+#include "FixedBoard.h"
 #include <iostream>
 #include <vector>
+#include <cstdlib>
+#include <ctime>
 
 
 #if defined(DEBUG) | defined(_DEBUG)
@@ -11,139 +14,126 @@
 
 namespace TicTacToe
 {
-    Board::Board(size_t width, size_t height, unsigned int alignementGoal)
-        : m_Width(width)
-        , m_Height(height)
-        , m_Size(width* height)
-        , m_AlignementGoal(alignementGoal)
-        , m_Board(new Piece[m_Size])
+    // Right, down, down-right and down-left, as {row step, column step}
+    static constexpr int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+    DynamicBoard::DynamicBoard(size_t width, size_t height, unsigned int alignementGoal)
+        : m_Width(width), m_Height(height), m_Size(width * height), m_AlignementGoal(alignementGoal)
+        , m_HasRows(RowBitboard::Fits(width, alignementGoal))
     {
-        SetEmpty();
+        m_Pieces[0] = CellMask(m_Size);
+        m_Pieces[1] = CellMask(m_Size);
+        ComputeWinningLines();
+        if (m_HasRows)
+            m_Rows = RowBitboard(width, height, alignementGoal);
     }
 
-    Board::~Board()
+    Piece DynamicBoard::GetPiece(size_t cell) const
     {
-        if (m_Board != nullptr)
-        {
-            delete[] m_Board;
-            m_Board = nullptr;
-        }
+        if (m_Pieces[0].Test(cell))
+            return Piece::X;
+        if (m_Pieces[1].Test(cell))
+            return Piece::O;
+        return Piece::Empty;
     }
 
-    bool Board::IsFull() const
+    void DynamicBoard::SetPiece(size_t cell, Piece piece)
     {
-        for (int i = 0; i < m_Size; i++)
-        {
-            if (m_Board[i] == Piece::Empty)
-            {
-                return false;
-            }
-        }
-        return true;
+        m_Pieces[0].Reset(cell);
+        m_Pieces[1].Reset(cell);
+        if (piece != Piece::Empty)
+            m_Pieces[static_cast<unsigned int>(piece) - 1].Set(cell);
+        if (m_HasRows)
+            m_Rows.Set(cell / m_Width, cell % m_Width, static_cast<unsigned int>(piece));
     }
 
-    // TODO: Needs to be reworked cauz it doesn't work if we change the grid size and the win condition
-    Piece Board::IsThereAWinner() const
+    Piece DynamicBoard::IsThereAWinner() const
     {
-        Piece winner = Piece::Empty;
-        unsigned int continuousPiecesCount = 0;
+        // Up to 64 cells a line mask is one word, cheaper than scanning the rows
+        if (m_HasRows && m_Size > CellMask::WORD_BITS)
+        {
+            const LineScan scan = m_Rows.Scan();
+            return scan.HasLine[0] ? Piece::X : scan.HasLine[1] ? Piece::O : Piece::Empty;
+        }
 
-        for (int i = 0; i < m_Size; i++)
+        for (const CellMask& line : m_WinningLines)
         {
-            if (m_Board[i] == Piece::Empty)
-            {
-                continue;
-            }
+            if (m_Pieces[0].Contains(line))
+                return Piece::X;
+            if (m_Pieces[1].Contains(line))
+                return Piece::O;
+        }
+
+        return Piece::Empty;
+    }
 
-            // Check for horizontal win
-            if (i % m_Width == 0)
+    Piece DynamicBoard::CheckWinAt(size_t cell) const
+    {
+        const Piece piece = GetPiece(cell);
+        if (piece == Piece::Empty)
+            return Piece::Empty;
+
+        const CellMask& side = m_Pieces[static_cast<unsigned int>(piece) - 1];
+        const int goal = static_cast<int>(m_AlignementGoal);
+        const int width = static_cast<int>(m_Width);
+        const int height = static_cast<int>(m_Height);
+        const int row = static_cast<int>(cell / m_Width);
+        const int col = static_cast<int>(cell % m_Width);
+
+        for (const auto& [rowStep, colStep] : DIRECTIONS)
+        {
+            int count = 1;
+            // Both ways from the cell, stopping at the first cell that isn't ours or at the edge
+            for (const int way : {1, -1})
             {
-                continuousPiecesCount = 0;
-                for (int j = 0; j < m_Width; j++)
+                int r = row + rowStep * way;
+                int c = col + colStep * way;
+                while (count < goal && r >= 0 && r < height && c >= 0 && c < width && side.Test(r * width + c))
                 {
-                    if (m_Board[i + j] != m_Board[i])
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        continuousPiecesCount++;
-                        if (continuousPiecesCount >= m_AlignementGoal)
-                        {
-                            return m_Board[i];
-                        }
-                    }
+                    count++;
+                    r += rowStep * way;
+                    c += colStep * way;
                 }
             }
 
-            // Check for vertical win
-            if (i < m_Width)
-            {
-                continuousPiecesCount = 0;
+            if (count >= goal)
+                return piece;
+        }
 
-                for (size_t j = 0; j < m_Size; j += m_Width)
-                {
-                    if (m_Board[i + j] != m_Board[i])
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        continuousPiecesCount++;
-                        if (continuousPiecesCount == m_AlignementGoal)
-                        {
-                            return m_Board[i];
-                        }
-                    }
-                }
-            }
+        return Piece::Empty;
+    }
 
-            // Check for top-left diagonal win
-            if (i == 0)
-            {
-                continuousPiecesCount = 0;
+    std::unique_ptr<BoardModel> MakeBoardModel(size_t width, size_t height, unsigned int alignementGoal)
+    {
+        // CLASSIC and FAST are both played on this size
+        if (width == 3 && height == 3 && alignementGoal == 3)
+            return std::make_unique<ClassicBoard>();
+        return std::make_unique<DynamicBoard>(width, height, alignementGoal);
+    }
 
-                for (size_t j = 0; j < m_Size; j += m_Width + 1)
-                {
-                    if (m_Board[i + j] != m_Board[i])
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        continuousPiecesCount++;
-                        if (continuousPiecesCount == m_AlignementGoal)
-                        {
-                            return m_Board[i];
-                        }
-                    }
-                }
-            }
+    Board::Board(size_t width, size_t height, unsigned int alignementGoal)
+        : m_AlignementGoal(alignementGoal)
+    {
+        Resize(width, height);
+    }
 
-            // Check  for top-right diagonal win
-            if (i == m_Width - 1)
-            {
-                continuousPiecesCount = 0;
+    Board::Board(const Board& other)
+        : m_Width(other.m_Width), m_Height(other.m_Height), m_Size(other.m_Size), m_AlignementGoal(other.m_AlignementGoal),
+        m_Model(other.m_Model->Clone())
+    {
+    }
 
-                for (size_t j = 0; j < m_Size - 1; j += m_Width - 1)
-                {
-                    if (m_Board[i + j] != m_Board[i])
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        continuousPiecesCount++;
-                        if (continuousPiecesCount == m_AlignementGoal)
-                        {
-                            return m_Board[i];
-                        }
-                    }
-                }
-            }
+    Board& Board::operator=(const Board& other)
+    {
+        if (this != &other)
+        {
+            m_Width = other.m_Width;
+            m_Height = other.m_Height;
+            m_Size = other.m_Size;
+            m_AlignementGoal = other.m_AlignementGoal;
+            m_Model = other.m_Model->Clone();
         }
-
-        return Piece::Empty;
+        return *this;
     }
 
     unsigned int Board::GetRandomEmptyCell() const
@@ -154,7 +144,7 @@ namespace TicTacToe
 
         for (unsigned int i = 0; i < m_Size; i++)
         {
-            if (m_Board[i] == Piece::Empty)
+            if (IsCellEmpty(i))
             {
                 emptyCells.push_back(i);
             }
@@ -168,16 +158,73 @@ namespace TicTacToe
         m_Width = width;
         m_Height = height;
         m_Size = width * height;
-        delete[] m_Board;
-        m_Board = new Piece[m_Size];
-        SetEmpty();
+        m_Model = MakeBoardModel(width, height, m_AlignementGoal);
     }
 
     void Board::SetEmpty()
     {
-        for (int i = 0; i < m_Size; i++)
+        m_Model->SetEmpty();
+    }
+
+    LineScan DynamicBoard::ScanLines() const
+    {
+        if (m_HasRows)
+            return m_Rows.Scan();
+
+        // Too wide for the rows, one line at a time
+        LineScan scan;
+        for (const CellMask& line : m_WinningLines)
+        {
+            const size_t pieces[2] = {m_Pieces[0].CountCommon(line), m_Pieces[1].CountCommon(line)};
+            for (unsigned int side = 0; side < 2; side++)
+            {
+                if (pieces[side] == m_AlignementGoal)
+                    scan.HasLine[side] = true;
+                else if (pieces[side] + 1 == m_AlignementGoal && pieces[1 - side] == 0)
+                    scan.Threats[side]++;
+            }
+        }
+        return scan;
+    }
+
+    void DynamicBoard::SetEmpty()
+    {
+        m_Pieces[0].Clear();
+        m_Pieces[1].Clear();
+        if (m_HasRows)
+            m_Rows.Clear();
+    }
+
+    void DynamicBoard::ComputeWinningLines()
+    {
+        m_WinningLines.clear();
+        if (m_AlignementGoal == 0)
+            return;
+
+        const int goal = static_cast<int>(m_AlignementGoal);
+        const int width = static_cast<int>(m_Width);
+        const int height = static_cast<int>(m_Height);
+
+        for (const auto& [rowStep, colStep] : DIRECTIONS)
         {
-            m_Board[i] = Piece::Empty;
+            for (int row = 0; row < height; row++)
+            {
+                for (int col = 0; col < width; col++)
+                {
+                    // The last cell of the line has to be on the board too
+                    const int lastRow = row + rowStep * (goal - 1);
+                    const int lastCol = col + colStep * (goal - 1);
+                    if (lastRow >= height || lastCol < 0 || lastCol >= width)
+                        continue;
+
+                    CellMask line(m_Size);
+                    for (int i = 0; i < goal; i++)
+                    {
+                        line.Set((row + rowStep * i) * width + col + colStep * i);
+                    }
+                    m_WinningLines.push_back(std::move(line));
+                }
+            }
         }
     }
 }
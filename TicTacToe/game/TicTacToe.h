@@ -1,4 +1,9 @@
 #pragma once
+#include "CellMask.h"
+#include "LineScan.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
 
 // Row, columns, alignment goal
 #define DEFAULT_BOARD_ARGS 3, 3, 3
@@ -17,11 +22,89 @@ namespace TicTacToe
     };
 
     /// <summary>
-    /// Represents a board of Tic-Tac-Toe.
+    /// The pieces of a board of a given size, and its win rules. Board hides which implementation it uses.
+    /// The cells are numbered row by row: `row * width + column`.
+    /// </summary>
+    class BoardModel
+    {
+    public:
+        virtual ~BoardModel() = default;
+
+        virtual Piece GetPiece(size_t cell) const = 0;
+        virtual void SetPiece(size_t cell, Piece piece) = 0;
+        virtual bool IsFull() const = 0;
+        virtual Piece IsThereAWinner() const = 0;
+        virtual Piece CheckWinAt(size_t cell) const = 0;
+        virtual LineScan ScanLines() const = 0;
+        virtual void SetEmpty() = 0;
+        virtual std::unique_ptr<BoardModel> Clone() const = 0;
+    };
+
+    /// <summary>
+    /// A board whose size is only known at run time, of any size.
+    /// The pieces of each side are a bitmask: a win is a line mask contained in the mask of a side, a full board a popcount.
+    /// Boards up to 16 columns are also kept as a RowBitboard, whose whole board scans run on SIMD registers.
+    /// </summary>
+    class DynamicBoard final : public BoardModel
+    {
+    public:
+        DynamicBoard(size_t width, size_t height, unsigned int alignementGoal);
+
+        Piece GetPiece(size_t cell) const override;
+        void SetPiece(size_t cell, Piece piece) override;
+        bool IsFull() const override { return m_Pieces[0].Count() + m_Pieces[1].Count() == m_Size; }
+        Piece IsThereAWinner() const override;
+        Piece CheckWinAt(size_t cell) const override;
+        LineScan ScanLines() const override;
+        void SetEmpty() override;
+        std::unique_ptr<BoardModel> Clone() const override { return std::make_unique<DynamicBoard>(*this); }
+
+    private:
+        /// <summary>
+        /// Lists every way to align the goal: rows, columns and both diagonals, at every position.
+        /// </summary>
+        void ComputeWinningLines();
+
+        size_t m_Width, m_Height, m_Size;
+        unsigned int m_AlignementGoal;
+        // The cells of X, then of O
+        CellMask m_Pieces[2];
+        // One mask per line of m_AlignementGoal cells
+        std::vector<CellMask> m_WinningLines;
+        // The same pieces by rows, if the board fits in one
+        bool m_HasRows;
+        RowBitboard m_Rows;
+    };
+
+    /// <summary>
+    /// Returns the fastest model for a board size: a FixedBoard for the sizes of the game modes, a DynamicBoard otherwise.
+    /// </summary>
+    std::unique_ptr<BoardModel> MakeBoardModel(size_t width, size_t height, unsigned int alignementGoal);
+
+    /// <summary>
+    /// Represents a board of Tic-Tac-Toe, of a size chosen at run time.
+    /// The pieces and the win rules are kept by a BoardModel picked for the size, see MakeBoardModel.
     /// </summary>
     class Board
     {
     public:
+        /// <summary>
+        /// A cell of a board, read and written like a Piece.
+        /// </summary>
+        class CellReference
+        {
+        public:
+            CellReference(Board& board, size_t cell) : m_Board(board), m_Cell(cell) {}
+
+            operator Piece() const { return m_Board.GetPiece(m_Cell); }
+            CellReference& operator=(Piece piece) { m_Board.SetPiece(m_Cell, piece); return *this; }
+            CellReference& operator=(const CellReference& other) { return *this = static_cast<Piece>(other); }
+
+        private:
+            Board& m_Board;
+            size_t m_Cell;
+        };
+
         /// <summary>
         /// Creates a 3x3 board with 3 pieces in a row needed to win.
         /// </summary>
@@ -29,43 +112,61 @@ namespace TicTacToe
         /// <summary>
         /// Creates a board with the specified width and height.
         /// </summary>
-        Board(size_t width, size_t height, unsigned int ²);
-        virtual ~Board();
+        Board(size_t width, size_t height, unsigned int alignementGoal);
+        Board(const Board& other);
+        Board(Board&& other) noexcept = default;
+        Board& operator=(const Board& other);
+        Board& operator=(Board&& other) noexcept = default;
+        virtual ~Board() = default;
 
         size_t GetWidth() const { return m_Width; }
         size_t GetHeight() const { return m_Height; }
         size_t GetTotalSize() const { return m_Size; }
+        unsigned int GetAlignementGoal() const { return m_AlignementGoal; }
+
+        Piece GetPiece(size_t cell) const { return m_Model->GetPiece(cell); }
+        void SetPiece(size_t cell, Piece piece) { m_Model->SetPiece(cell, piece); }
 
         /// <summary>
         /// Returns a reference to the piece at the specified row and column.
         /// </summary>
-        Piece& operator()(size_t row, size_t col) { return m_Board[row * m_Width + col]; }
+        CellReference operator()(size_t row, size_t col) { return CellReference(*this, row * m_Width + col); }
         /// <summary>
-        /// Returns a const reference to the piece at the specified row and column.
+        /// Returns the piece at the specified row and column.
         /// </summary>
-        const Piece& operator()(size_t row, size_t col) const { return m_Board[row * m_Width + col]; }
+        Piece operator()(size_t row, size_t col) const { return GetPiece(row * m_Width + col); }
         /// <summary>
         /// Returns a reference to the piece at the specified index.
         /// </summary>
-        Piece& operator[](size_t index) { return m_Board[index]; }
+        CellReference operator[](size_t index) { return CellReference(*this, index); }
         /// <summary>
-        /// Returns a const reference to the piece at the specified index.
+        /// Returns the piece at the specified index.
         /// </summary>
-        const Piece& operator[](size_t index) const { return m_Board[index]; }
+        Piece operator[](size_t index) const { return GetPiece(index); }
 
         /// <summary>
         /// Returns true if the board does not contain any empty pieces.
         /// </summary>
-        bool IsFull() const;
+        bool IsFull() const { return m_Model->IsFull(); }
 
         /// <summary>
         /// Returns the winning piece, or the empty piece if there is no winner.
         /// </summary>
-        Piece IsThereAWinner() const;
+        Piece IsThereAWinner() const { return m_Model->IsThereAWinner(); }
+        /// <summary>
+        /// Returns the piece of a cell if it completes an alignment of the goal, or the empty piece.
+        /// Only the lines through the cell are looked at, in O(goal): check the last move with it.
+        /// </summary>
+        Piece CheckWinAt(size_t cell) const { return m_Model->CheckWinAt(cell); }
+        /// <summary>
+        /// Scans every row, column and diagonal for the lines and the threats of both sides.
+        /// Runs on SIMD registers for boards up to 16 columns: use it to evaluate whole positions.
+        /// </summary>
+        LineScan ScanLines() const { return m_Model->ScanLines(); }
 
         unsigned int GetRandomEmptyCell() const;
 
-        bool IsCellEmpty(unsigned int cell) { return m_Board[cell] == Piece::Empty; }
+        bool IsCellEmpty(unsigned int cell) const { return GetPiece(cell) == Piece::Empty; }
 
         /// <summary>
         /// Resizes the board to the specified width and height.
@@ -78,9 +179,8 @@ namespace TicTacToe
         virtual void SetEmpty();
 
     protected:
-
         size_t m_Width = 3, m_Height = 3, m_Size = 9;
         unsigned int m_AlignementGoal = 3;
-        Piece* m_Board;
+        std::unique_ptr<BoardModel> m_Model;
     };
 }
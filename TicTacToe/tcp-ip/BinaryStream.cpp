@@ -0,0 +1,98 @@
+#include "BinaryStream.h"
+
+void BinaryWriter::WriteUInt(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        m_Output.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    m_Output.push_back(static_cast<char>(value));
+}
+
+void BinaryWriter::WriteInt(int64_t value)
+{
+    // Zigzag: small negative numbers stay small (-1 -> 1, 1 -> 2)
+    WriteUInt((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void BinaryWriter::WriteString(std::string_view value)
+{
+    WriteUInt(value.size());
+    m_Output.append(value.data(), value.size());
+}
+
+uint8_t BinaryReader::ReadByte()
+{
+    if (m_Position >= m_Size)
+        throw std::runtime_error("Binary message ended too early");
+    return static_cast<uint8_t>(m_Data[m_Position++]);
+}
+
+bool BinaryReader::ReadBool()
+{
+    const uint8_t value = ReadByte();
+    if (value > 1)
+        throw std::runtime_error("Binary message has an invalid bool");
+    return value == 1;
+}
+
+uint64_t BinaryReader::ReadUInt()
+{
+    uint64_t value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+        const uint8_t byte = ReadByte();
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return value;
+    }
+    throw std::runtime_error("Binary message has a varint longer than 64 bits");
+}
+
+int64_t BinaryReader::ReadInt()
+{
+    const uint64_t value = ReadUInt();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+std::string BinaryReader::ReadString()
+{
+    const uint64_t size = ReadUInt();
+    if (size > GetRemaining())
+        throw std::runtime_error("Binary message has a string longer than the message");
+
+    std::string value(m_Data + m_Position, static_cast<size_t>(size));
+    m_Position += static_cast<size_t>(size);
+    return value;
+}
+
+unsigned int BinaryReader::ReadUInt32()
+{
+    const uint64_t value = ReadUInt();
+    if (value > UINT32_MAX)
+        throw std::runtime_error("Binary message has a value out of range");
+    return static_cast<unsigned int>(value);
+}
+
+int BinaryReader::ReadInt32()
+{
+    const int64_t value = ReadInt();
+    if (value < INT32_MIN || value > INT32_MAX)
+        throw std::runtime_error("Binary message has a value out of range");
+    return static_cast<int>(value);
+}
+
+size_t BinaryReader::ReadCount()
+{
+    const uint64_t count = ReadUInt();
+    if (count > GetRemaining())
+        throw std::runtime_error("Binary message has a list longer than the message");
+    return static_cast<size_t>(count);
+}
+
+void BinaryReader::ExpectEnd() const
+{
+    if (m_Position != m_Size)
+        throw std::runtime_error("Binary message is longer than expected");
+}
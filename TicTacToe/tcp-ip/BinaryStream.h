@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/// <summary>
+/// Appends values to a buffer in the compact binary encoding of the messages.
+/// Unsigned integers and enums are varints (7 bits per byte, low bits first), signed integers are zigzagged first,
+/// strings and lists are prefixed by their size.
+/// </summary>
+class BinaryWriter final
+{
+public:
+    explicit BinaryWriter(std::string& output) : m_Output(output) {}
+
+    void WriteByte(uint8_t value) { m_Output.push_back(static_cast<char>(value)); }
+    void WriteBool(bool value) { WriteByte(value ? 1 : 0); }
+    void WriteUInt(uint64_t value);
+    void WriteInt(int64_t value);
+    void WriteString(std::string_view value);
+
+    template <typename E>
+    void WriteEnum(E value) { WriteUInt(static_cast<uint64_t>(value)); }
+
+private:
+    std::string& m_Output;
+};
+
+/// <summary>
+/// Reads values written by a BinaryWriter.
+/// Throws std::runtime_error when the data ends too early or holds a value out of range.
+/// </summary>
+class BinaryReader final
+{
+public:
+    BinaryReader(const char* data, size_t size) : m_Data(data), m_Size(size) {}
+
+    uint8_t ReadByte();
+    bool ReadBool();
+    uint64_t ReadUInt();
+    int64_t ReadInt();
+    std::string ReadString();
+
+    /// <summary>
+    /// Reads an unsigned integer that must fit in 32 bits.
+    /// </summary>
+    unsigned int ReadUInt32();
+    /// <summary>
+    /// Reads a signed integer that must fit in 32 bits.
+    /// </summary>
+    int ReadInt32();
+    /// <summary>
+    /// Reads a list size, checking that the data can hold that many elements. (At least one byte each)
+    /// </summary>
+    size_t ReadCount();
+
+    template <typename E>
+    E ReadEnum() { return static_cast<E>(ReadUInt32()); }
+
+    size_t GetRemaining() const { return m_Size - m_Position; }
+    /// <summary>
+    /// Throws if some data was not read, the message is not the one we expected.
+    /// </summary>
+    void ExpectEnd() const;
+
+private:
+    const char* m_Data;
+    size_t m_Size;
+    size_t m_Position = 0;
+};
@@ -3,118 +3,84 @@
 #include "../game/TicTacToe.h"
 
 template <>
-struct Message<MsgType::Login> : ISerializable
+struct Message<MsgType::Login>
 {
-    Message() = default;
-    Message(const Json& j)
-    {
-        Username = j["Username"].get<std::string>();
-    }
-    ~Message() = default;
+    std::string Username;
+    // The encoding the server has to use for this client. (Older clients don't send it)
+    MessageEncoding Encoding = MessageEncoding::Json;
 
-    Json Serialize() override
+    static constexpr auto GetFields()
     {
-        Json j;
-        j["Type"] = MsgType::Login;
-        j["Username"] = Username;
-        return j;
+        return std::make_tuple(
+            MakeField("Username", &Message::Username),
+            MakeOptionalField("Encoding", &Message::Encoding));
     }
-
-    std::string Username;
 };
 
 template <>
-struct Message<MsgType::OnEnterLobby> : ISerializable
+struct Message<MsgType::FetchLobbyList>
 {
-    Message() = default;
-    Message(const Json& j)
-    {
-        LobbyId = j["ID"].get<unsigned int>();
-    }
-    ~Message() = default;
+    // Version of the lobby list the client already has, 0 if none.
+    // The server answers with the changes since that version when it still knows them, with the whole list otherwise.
+    unsigned int KnownVersion = 0;
 
-    Json Serialize() override
+    static constexpr auto GetFields()
     {
-        Json j;
-        j["Type"] = MsgType::OnEnterLobby;
-        j["ID"] = LobbyId;
-
-        return j;
+        return std::make_tuple(
+            MakeOptionalField("KnownVersion", &Message::KnownVersion));
     }
-
-    unsigned int LobbyId;
 };
 
 template <>
-struct Message<MsgType::LeaveLobby> : ISerializable
+struct Message<MsgType::OnEnterLobby>
 {
-    Message() = default;
-    Message(const Json& j)
-    {
-        LobbyId = j["ID"].get<unsigned int>();
-        PlayerName = j["PlayerName"];
-    }
-    ~Message() = default;
+    unsigned int LobbyId;
 
-    Json Serialize() override
+    static constexpr auto GetFields()
     {
-        Json j;
-        j["Type"] = MsgType::LeaveLobby;
-        j["ID"] = LobbyId;
-        j["PlayerName"] = PlayerName;
-
-        return j;
+        return std::make_tuple(
+            MakeField("ID", &Message::LobbyId));
     }
-
-    unsigned int LobbyId;
-    std::string PlayerName;
 };
 
 template <>
-struct Message<MsgType::TryToJoinLobby> : ISerializable
+struct Message<MsgType::LeaveLobby>
 {
-    Message() = default;
-    Message(const Json& j)
-    {
-        LobbyId = j["ID"].get<unsigned int>();
-    }
-    ~Message() = default;
+    unsigned int LobbyId;
+    std::string PlayerName;
 
-    Json Serialize() override
+    static constexpr auto GetFields()
     {
-        Json j;
-        j["Type"] = MsgType::TryToJoinLobby;
-        j["ID"] = LobbyId;
-
-        return j;
+        return std::make_tuple(
+            MakeField("ID", &Message::LobbyId),
+            MakeField("PlayerName", &Message::PlayerName));
     }
-
-    unsigned int LobbyId;
 };
 
 template <>
-struct Message<MsgType::MakeMove> : ISerializable
+struct Message<MsgType::TryToJoinLobby>
 {
-    Message() = default;
-    Message(const Json& j)
-    {
-        LobbyId = j["ID"].get<unsigned int>();
-        Cell = j["Cell"].get<unsigned int>();
-        Piece = j["Piece"].get<TicTacToe::Piece>();
-    }
-    ~Message() = default;
+    unsigned int LobbyId;
 
-    Json Serialize() override
+    static constexpr auto GetFields()
     {
-        Json j;
-        j["Type"] = MsgType::MakeMove;
-        j["ID"] = LobbyId;
-        j["Cell"] = Cell;
-        j["Piece"] = Piece;
-        return j;
+        return std::make_tuple(
+            MakeField("ID", &Message::LobbyId));
     }
+};
 
+template <>
+struct Message<MsgType::MakeMove>
+{
     unsigned int LobbyId;
     unsigned int Cell;
     TicTacToe::Piece Piece;
+
+    static constexpr auto GetFields()
+    {
+        return std::make_tuple(
+            MakeField("ID", &Message::LobbyId),
+            MakeField("Cell", &Message::Cell),
+            MakeField("Piece", &Message::Piece));
+    }
 };
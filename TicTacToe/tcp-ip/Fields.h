@@ -0,0 +1,34 @@
+#pragma once
+#include <tuple>
+
+/// <summary>
+/// Describes a serialized field: its JSON key and the member holding it.
+/// A serialized struct lists its fields once, in a static constexpr GetFields() returning a tuple of them.
+/// The functions of Serializer.h read and write every encoding from that list. (Binary writes them in this order)
+/// </summary>
+template <typename Owner, typename T>
+struct Field
+{
+    const char* Name;
+    T Owner::* Member;
+    // A JSON object without this key keeps the default value, instead of being rejected. (For fields added later)
+    bool IsOptional;
+};
+
+template <typename Owner, typename T>
+constexpr Field<Owner, T> MakeField(const char* name, T Owner::* member)
+{
+    return { name, member, false };
+}
+
+template <typename Owner, typename T>
+constexpr Field<Owner, T> MakeOptionalField(const char* name, T Owner::* member)
+{
+    return { name, member, true };
+}
+
+/// <summary>
+/// A struct that lists its fields, see Field.
+/// </summary>
+template <typename T>
+concept HasFields = requires { T::GetFields(); };
@@ -0,0 +1,108 @@
+#include "FrameDecoder.h"
+#include <cstring>
+
+namespace TcpIp
+{
+    using enum ErrorCode;
+
+    char* FrameDecoder::Prepare(size_t size)
+    {
+        // Move the unread bytes to the front before growing, so the buffer does not grow forever
+        if (m_Begin > 0 && m_Buffer.size() - m_End < size)
+        {
+            memmove(m_Buffer.data(), m_Buffer.data() + m_Begin, m_End - m_Begin);
+            m_End -= m_Begin;
+            m_Begin = 0;
+        }
+
+        if (m_Buffer.size() - m_End < size)
+            m_Buffer.resize(m_End + size);
+
+        return m_Buffer.data() + m_End;
+    }
+
+    void FrameDecoder::Commit(size_t size)
+    {
+        m_End += size;
+    }
+
+    void FrameDecoder::Feed(const char* data, size_t size)
+    {
+        memcpy(Prepare(size), data, size);
+        Commit(size);
+    }
+
+    bool FrameDecoder::Next(Frame& frame)
+    {
+        if (GetBufferedSize() < HEADER_SIZE)
+            return false; // Header is not complete yet
+
+        const char* header = m_Buffer.data() + m_Begin;
+        if (memcmp(header, HEADER_SIGNATURE, HEADER_SIGNATURE_SIZE) != 0)
+            throw TcpIpException::Create(RECEIVE_HeaderHadInvalidSignature);
+
+        uint32_t networkSize;
+        memcpy(&networkSize, header + HEADER_DATA_SIZE_OFFSET, sizeof(uint32_t));
+        const uint32_t dataSize = ntohl(networkSize); // Convert to host byte order
+
+        if (dataSize > MAX_FRAME_DATA_SIZE)
+            throw TcpIpException::Create(RECEIVE_FrameTooLarge, static_cast<int>(dataSize));
+
+        if (GetBufferedSize() < HEADER_SIZE + dataSize)
+            return false; // Data is not complete yet
+
+        frame.Info.Type = static_cast<uint8_t>(header[HEADER_TYPE_OFFSET]);
+        frame.Info.Flags = static_cast<uint8_t>(header[HEADER_FLAGS_OFFSET]);
+        frame.Data.assign(header + HEADER_SIZE, dataSize);
+        m_Begin += HEADER_SIZE + dataSize;
+
+        // Everything has been read, start again from the front of the buffer
+        if (m_Begin == m_End)
+            m_Begin = m_End = 0;
+        return true;
+    }
+
+    void FrameDecoder::Clear()
+    {
+        m_Begin = m_End = 0;
+    }
+
+    bool ReceiveFrames(const SOCKET& socket, FrameDecoder& decoder, std::vector<Frame>& frames)
+    {
+        bool isOpen = true;
+        Frame frame;
+        size_t received = 0;
+        while (received < MAX_RECEIVE_SIZE)
+        {
+            char* buffer = decoder.Prepare(DEFAULT_BUFFER_SIZE);
+            int iResult = recv(socket, buffer, static_cast<int>(DEFAULT_BUFFER_SIZE), 0);
+
+            if (iResult == SOCKET_ERROR)
+            {
+                if (IsWouldBlockError(WSAGetLastError()))
+                    break; // Nothing left to read
+                throw TcpIpException::Create(RECEIVE_DataFailed, TCP_IP_WSA_ERROR);
+            }
+
+            if (iResult == 0) // Peer has shut down the connection
+            {
+                isOpen = false;
+                break;
+            }
+
+            decoder.Commit(iResult);
+            received += iResult;
+
+            // Extract as we read: a bad or oversized header is rejected before more of its data is buffered
+            while (decoder.Next(frame))
+            {
+                frames.push_back(std::move(frame));
+            }
+
+            // The socket had less than asked, it is empty now
+            if (static_cast<size_t>(iResult) < DEFAULT_BUFFER_SIZE)
+                break;
+        }
+        return isOpen;
+    }
+}
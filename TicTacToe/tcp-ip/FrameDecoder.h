@@ -0,0 +1,60 @@
+#pragma once
+#include "TcpIp.h"
+#include <vector>
+
+namespace TcpIp
+{
+    /// <summary>
+    /// Rebuilds frames from a TCP stream.
+    /// TCP can split a frame across several reads, or put several frames in one read,
+    /// so the received bytes are kept until a whole frame (header + data) is available.
+    /// </summary>
+    class FrameDecoder final
+    {
+    public:
+        FrameDecoder() = default;
+
+        /// <summary>
+        /// Returns a pointer where at least `size` bytes can be written, at the end of the buffered data.
+        /// Call Commit() with the number of bytes actually written.
+        /// </summary>
+        char* Prepare(size_t size);
+        /// <summary>
+        /// Adds the bytes written after the last Prepare() to the buffered data.
+        /// </summary>
+        void Commit(size_t size);
+        /// <summary>
+        /// Copies received bytes to the end of the buffered data.
+        /// </summary>
+        void Feed(const char* data, size_t size);
+
+        /// <summary>
+        /// Extracts the next complete frame: its header info and its data.
+        /// Throws if the buffered header is not one of ours, the stream cannot be recovered in that case.
+        /// </summary>
+        /// <returns>True if a frame was extracted, false if more bytes are needed.</returns>
+        bool Next(Frame& frame);
+
+        /// <summary>
+        /// Returns the number of bytes received but not extracted yet.
+        /// </summary>
+        size_t GetBufferedSize() const { return m_End - m_Begin; }
+        /// <summary>
+        /// Drops all buffered bytes.
+        /// </summary>
+        void Clear();
+
+    private:
+        std::vector<char> m_Buffer;
+        size_t m_Begin = 0;
+        size_t m_End = 0;
+    };
+
+    /// <summary>
+    /// Reads what is available on a non-blocking socket, up to MAX_RECEIVE_SIZE bytes, and extracts every complete frame.
+    /// The readiness of the socket is reported again while bytes are left in it.
+    /// </summary>
+    /// <param name="frames">Each complete frame is appended to this vector.</param>
+    /// <returns>False if the peer has shut down the connection.</returns>
+    bool ReceiveFrames(const SOCKET& socket, FrameDecoder& decoder, std::vector<Frame>& frames);
+}
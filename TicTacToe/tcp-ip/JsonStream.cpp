@@ -0,0 +1,465 @@
+#include "JsonStream.h"
+#include <charconv>
+#include <stdexcept>
+
+void JsonWriter::BeginObject()
+{
+    BeginValue();
+    m_Output.push_back('{');
+    m_NeedsComma = false;
+}
+
+void JsonWriter::EndObject()
+{
+    m_Output.push_back('}');
+    m_NeedsComma = true;
+}
+
+void JsonWriter::BeginArray()
+{
+    BeginValue();
+    m_Output.push_back('[');
+    m_NeedsComma = false;
+}
+
+void JsonWriter::EndArray()
+{
+    m_Output.push_back(']');
+    m_NeedsComma = true;
+}
+
+void JsonWriter::WriteKey(std::string_view key)
+{
+    BeginValue();
+    m_Output.push_back('"');
+    m_Output.append(key.data(), key.size());
+    m_Output.append("\":", 2);
+    // The value follows the key directly
+    m_NeedsComma = false;
+}
+
+void JsonWriter::WriteUInt(uint64_t value)
+{
+    BeginValue();
+    char buffer[20];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    m_Output.append(buffer, result.ptr - buffer);
+    m_NeedsComma = true;
+}
+
+void JsonWriter::WriteInt(int64_t value)
+{
+    BeginValue();
+    char buffer[20];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    m_Output.append(buffer, result.ptr - buffer);
+    m_NeedsComma = true;
+}
+
+void JsonWriter::WriteBool(bool value)
+{
+    BeginValue();
+    if (value)
+        m_Output.append("true", 4);
+    else
+        m_Output.append("false", 5);
+    m_NeedsComma = true;
+}
+
+void JsonWriter::WriteString(std::string_view value)
+{
+    static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+    BeginValue();
+    m_Output.push_back('"');
+    for (const char c : value)
+    {
+        switch (c)
+        {
+        case '"': m_Output.append("\\\"", 2); break;
+        case '\\': m_Output.append("\\\\", 2); break;
+        case '\n': m_Output.append("\\n", 2); break;
+        case '\r': m_Output.append("\\r", 2); break;
+        case '\t': m_Output.append("\\t", 2); break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                // Other control characters have no short escape
+                const char escaped[] = { '\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xF] };
+                m_Output.append(escaped, sizeof(escaped));
+            }
+            else
+                m_Output.push_back(c);
+            break;
+        }
+    }
+    m_Output.push_back('"');
+    m_NeedsComma = true;
+}
+
+void JsonWriter::BeginValue()
+{
+    if (m_NeedsComma)
+        m_Output.push_back(',');
+}
+
+void JsonReader::BeginObject()
+{
+    Expect('{');
+    m_IsFirst = true;
+}
+
+bool JsonReader::NextKey(std::string_view& key)
+{
+    if (Peek() == '}')
+    {
+        ++m_Position;
+        m_IsFirst = false;
+        return false;
+    }
+    if (!m_IsFirst)
+        Expect(',');
+    m_IsFirst = false;
+
+    if (Peek() != '"')
+        Fail("expected a key");
+    key = ReadStringView(m_KeyBuffer);
+    Expect(':');
+    return true;
+}
+
+void JsonReader::BeginArray()
+{
+    Expect('[');
+    m_IsFirst = true;
+}
+
+bool JsonReader::NextElement()
+{
+    if (Peek() == ']')
+    {
+        ++m_Position;
+        m_IsFirst = false;
+        return false;
+    }
+    if (!m_IsFirst)
+        Expect(',');
+    m_IsFirst = false;
+    return true;
+}
+
+uint64_t JsonReader::ReadUInt()
+{
+    const char c = Peek();
+    if (c < '0' || c > '9')
+        Fail("expected a positive integer");
+
+    uint64_t value = 0;
+    while (m_Position < m_Data.size() && m_Data[m_Position] >= '0' && m_Data[m_Position] <= '9')
+    {
+        const uint64_t digit = m_Data[m_Position] - '0';
+        if (value > (UINT64_MAX - digit) / 10)
+            Fail("integer is too large");
+        value = value * 10 + digit;
+        ++m_Position;
+    }
+
+    if (m_Position < m_Data.size() && (m_Data[m_Position] == '.' || m_Data[m_Position] == 'e' || m_Data[m_Position] == 'E'))
+        Fail("expected an integer");
+    return value;
+}
+
+int64_t JsonReader::ReadInt()
+{
+    if (Peek() != '-')
+    {
+        const uint64_t value = ReadUInt();
+        if (value > INT64_MAX)
+            Fail("integer is too large");
+        return static_cast<int64_t>(value);
+    }
+
+    ++m_Position;
+    const uint64_t magnitude = ReadUInt();
+    if (magnitude > static_cast<uint64_t>(INT64_MAX) + 1)
+        Fail("integer is too small");
+    return static_cast<int64_t>(0 - magnitude);
+}
+
+bool JsonReader::ReadBool()
+{
+    if (Peek() == 't')
+    {
+        ExpectLiteral("true");
+        return true;
+    }
+    ExpectLiteral("false");
+    return false;
+}
+
+void JsonReader::ReadString(std::string& value)
+{
+    if (Peek() != '"')
+        Fail("expected a string");
+
+    const std::string_view view = ReadStringView(value);
+    if (view.data() != value.data())
+        value.assign(view.data(), view.size());
+}
+
+unsigned int JsonReader::ReadUInt32()
+{
+    const uint64_t value = ReadUInt();
+    if (value > UINT32_MAX)
+        Fail("value out of range");
+    return static_cast<unsigned int>(value);
+}
+
+int JsonReader::ReadInt32()
+{
+    const int64_t value = ReadInt();
+    if (value < INT32_MIN || value > INT32_MAX)
+        Fail("value out of range");
+    return static_cast<int>(value);
+}
+
+void JsonReader::SkipValue()
+{
+    SkipValue(0);
+}
+
+void JsonReader::ExpectEnd()
+{
+    SkipWhitespace();
+    if (m_Position != m_Data.size())
+        Fail("unexpected data after the value");
+}
+
+void JsonReader::Fail(const char* reason) const
+{
+    throw std::runtime_error("Invalid JSON at " + std::to_string(m_Position) + ": " + reason);
+}
+
+void JsonReader::SkipWhitespace()
+{
+    while (m_Position < m_Data.size())
+    {
+        const char c = m_Data[m_Position];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+            break;
+        ++m_Position;
+    }
+}
+
+char JsonReader::Peek()
+{
+    SkipWhitespace();
+    return m_Position < m_Data.size() ? m_Data[m_Position] : '\0';
+}
+
+void JsonReader::Expect(char c)
+{
+    if (Peek() != c)
+    {
+        const char reason[] = { 'e', 'x', 'p', 'e', 'c', 't', 'e', 'd', ' ', '\'', c, '\'', '\0' };
+        Fail(reason);
+    }
+    ++m_Position;
+}
+
+void JsonReader::ExpectLiteral(std::string_view literal)
+{
+    if (m_Data.compare(m_Position, literal.size(), literal) != 0)
+        Fail("invalid literal");
+    m_Position += literal.size();
+}
+
+std::string_view JsonReader::ReadStringView(std::string& buffer)
+{
+    // Called on the opening quote
+    const size_t start = ++m_Position;
+    while (m_Position < m_Data.size())
+    {
+        const char c = m_Data[m_Position];
+        if (c == '"')
+            return m_Data.substr(start, m_Position++ - start);
+        if (c == '\\')
+            break;
+        if (static_cast<unsigned char>(c) < 0x20)
+            Fail("control character in a string");
+        ++m_Position;
+    }
+    if (m_Position >= m_Data.size())
+        Fail("unterminated string");
+
+    // There are escapes, the string is decoded in the buffer
+    buffer.assign(m_Data.data() + start, m_Position - start);
+    while (true)
+    {
+        if (m_Position >= m_Data.size())
+            Fail("unterminated string");
+
+        const char c = m_Data[m_Position++];
+        if (c == '"')
+            return buffer;
+        if (static_cast<unsigned char>(c) < 0x20)
+            Fail("control character in a string");
+        if (c != '\\')
+        {
+            buffer.push_back(c);
+            continue;
+        }
+
+        if (m_Position >= m_Data.size())
+            Fail("unterminated string");
+        switch (m_Data[m_Position++])
+        {
+        case '"': buffer.push_back('"'); break;
+        case '\\': buffer.push_back('\\'); break;
+        case '/': buffer.push_back('/'); break;
+        case 'b': buffer.push_back('\b'); break;
+        case 'f': buffer.push_back('\f'); break;
+        case 'n': buffer.push_back('\n'); break;
+        case 'r': buffer.push_back('\r'); break;
+        case 't': buffer.push_back('\t'); break;
+        case 'u':
+        {
+            unsigned int codePoint = ReadHex4();
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+            {
+                // High surrogate, the low one must follow
+                if (m_Data.compare(m_Position, 2, "\\u") != 0)
+                    Fail("lone surrogate");
+                m_Position += 2;
+                const unsigned int low = ReadHex4();
+                if (low < 0xDC00 || low > 0xDFFF)
+                    Fail("lone surrogate");
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            }
+            else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF)
+                Fail("lone surrogate");
+
+            // UTF-8
+            if (codePoint < 0x80)
+                buffer.push_back(static_cast<char>(codePoint));
+            else if (codePoint < 0x800)
+            {
+                buffer.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+                buffer.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+            else if (codePoint < 0x10000)
+            {
+                buffer.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+                buffer.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                buffer.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+            else
+            {
+                buffer.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+                buffer.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+                buffer.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                buffer.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+            break;
+        }
+        default:
+            Fail("invalid escape");
+        }
+    }
+}
+
+unsigned int JsonReader::ReadHex4()
+{
+    if (m_Position + 4 > m_Data.size())
+        Fail("unterminated escape");
+
+    unsigned int value = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        const char c = m_Data[m_Position++];
+        value <<= 4;
+        if (c >= '0' && c <= '9')
+            value |= c - '0';
+        else if (c >= 'a' && c <= 'f')
+            value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            value |= c - 'A' + 10;
+        else
+            Fail("invalid escape");
+    }
+    return value;
+}
+
+void JsonReader::SkipNumber()
+{
+    auto skipDigits = [this]()
+    {
+        const size_t start = m_Position;
+        while (m_Position < m_Data.size() && m_Data[m_Position] >= '0' && m_Data[m_Position] <= '9')
+        {
+            ++m_Position;
+        }
+        if (m_Position == start)
+            Fail("invalid number");
+    };
+
+    if (m_Data[m_Position] == '-')
+        ++m_Position;
+    skipDigits();
+    if (m_Position < m_Data.size() && m_Data[m_Position] == '.')
+    {
+        ++m_Position;
+        skipDigits();
+    }
+    if (m_Position < m_Data.size() && (m_Data[m_Position] == 'e' || m_Data[m_Position] == 'E'))
+    {
+        ++m_Position;
+        if (m_Position < m_Data.size() && (m_Data[m_Position] == '+' || m_Data[m_Position] == '-'))
+            ++m_Position;
+        skipDigits();
+    }
+}
+
+void JsonReader::SkipValue(unsigned int depth)
+{
+    if (depth >= MAX_DEPTH)
+        Fail("too deeply nested");
+
+    std::string_view key;
+    const char c = Peek();
+    switch (c)
+    {
+    case '{':
+        BeginObject();
+        while (NextKey(key))
+        {
+            SkipValue(depth + 1);
+        }
+        break;
+    case '[':
+        BeginArray();
+        while (NextElement())
+        {
+            SkipValue(depth + 1);
+        }
+        break;
+    case '"':
+        ReadStringView(m_KeyBuffer);
+        break;
+    case 't':
+        ExpectLiteral("true");
+        break;
+    case 'f':
+        ExpectLiteral("false");
+        break;
+    case 'n':
+        ExpectLiteral("null");
+        break;
+    default:
+        // Also the end of the data
+        if (c != '-' && (c < '0' || c > '9'))
+            Fail("expected a value");
+        SkipNumber();
+        break;
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/// <summary>
+/// Appends compact JSON text to a buffer, without building a Json object first.
+/// Commas are added between the values of an object or an array, the caller only has to balance Begin/End.
+/// </summary>
+class JsonWriter final
+{
+public:
+    explicit JsonWriter(std::string& output) : m_Output(output) {}
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    /// <summary>
+    /// Writes the key of the next value of an object. (Written as is, keys are never escaped)
+    /// </summary>
+    void WriteKey(std::string_view key);
+
+    void WriteUInt(uint64_t value);
+    void WriteInt(int64_t value);
+    void WriteBool(bool value);
+    void WriteString(std::string_view value);
+
+private:
+    // Adds the comma separating a value from the previous one
+    void BeginValue();
+
+    std::string& m_Output;
+    bool m_NeedsComma = false;
+};
+
+/// <summary>
+/// Reads JSON text token by token, without building a document: the caller asks for the values it expects.
+/// Objects are read with BeginObject, then NextKey until it returns false, reading or skipping the value of each key.
+/// Throws std::runtime_error on invalid JSON or on a value of another kind than asked.
+/// </summary>
+class JsonReader final
+{
+public:
+    explicit JsonReader(std::string_view data) : m_Data(data) {}
+
+    void BeginObject();
+    /// <summary>
+    /// Moves to the next key of the current object.
+    /// </summary>
+    /// <returns>False at the end of the object.</returns>
+    bool NextKey(std::string_view& key);
+    void BeginArray();
+    /// <summary>
+    /// Moves to the next element of the current array.
+    /// </summary>
+    /// <returns>False at the end of the array.</returns>
+    bool NextElement();
+
+    /// <summary>
+    /// Reads an integer, fractions and exponents are rejected.
+    /// </summary>
+    uint64_t ReadUInt();
+    int64_t ReadInt();
+    bool ReadBool();
+    void ReadString(std::string& value);
+
+    /// <summary>
+    /// Reads an unsigned integer that must fit in 32 bits.
+    /// </summary>
+    unsigned int ReadUInt32();
+    /// <summary>
+    /// Reads a signed integer that must fit in 32 bits.
+    /// </summary>
+    int ReadInt32();
+
+    template <typename E>
+    E ReadEnum() { return static_cast<E>(ReadUInt32()); }
+
+    /// <summary>
+    /// Skips a value of any kind, checking that it is valid JSON.
+    /// </summary>
+    void SkipValue();
+    /// <summary>
+    /// Throws if anything but whitespace follows the value that was read.
+    /// </summary>
+    void ExpectEnd();
+
+private:
+    // Deeper values are rejected, so skipping them can't exhaust the stack
+    static constexpr unsigned int MAX_DEPTH = 32;
+
+    [[noreturn]] void Fail(const char* reason) const;
+    void SkipWhitespace();
+    // Skips whitespace and returns the next character without reading it, 0 at the end of the data
+    char Peek();
+    void Expect(char c);
+    void ExpectLiteral(std::string_view literal);
+    // Reads the string at the current position. The view points in the data if there is no escape, in `buffer` otherwise.
+    std::string_view ReadStringView(std::string& buffer);
+    unsigned int ReadHex4();
+    void SkipNumber();
+    void SkipValue(unsigned int depth);
+
+    std::string_view m_Data;
+    size_t m_Position = 0;
+    // True right after entering an object or an array: the next key or element is not preceded by a comma
+    bool m_IsFirst = false;
+    // Holds the keys that have escapes
+    std::string m_KeyBuffer;
+};
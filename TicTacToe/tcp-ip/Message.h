@@ -1,5 +1,7 @@
 #pragma once
-#include "ISerializable.h"
+#include "Fields.h"
+#include <cstddef>
+#include <string>
 
 enum class MsgType : unsigned int
 {
@@ -35,23 +37,28 @@ enum class MsgType : unsigned int
     DeclineMakeMove,
     GameOver,
 };
+// Size of the tables indexed by MsgType
+constexpr size_t MSG_TYPE_COUNT = static_cast<size_t>(MsgType::GameOver) + 1;
 
+/// <summary>
+/// How the messages of a connection are written. The client chooses it with its Login message,
+/// the server answers in JSON until then.
+/// </summary>
+enum class MessageEncoding : unsigned int
+{
+    // Readable, for debugging and older clients
+    Json = 0,
+    // The type as first byte, then the fields in a fixed order. (See BinaryWriter)
+    Binary = 1,
+};
+constexpr size_t MESSAGE_ENCODING_COUNT = 2;
+
+/// <summary>
+/// A message of the protocol. The specializations of ClientMessages.h and ServerMessages.h list their fields,
+/// MessageCodec.h reads and writes them. Messages without a specialization have no field.
+/// </summary>
 template <MsgType T = MsgType::Unknown>
-struct Message : ISerializable
+struct Message
 {
-    Message() = default;
-
-    static MsgType GetType(const Json& j)
-    {
-        if (j.contains("Type"))
-            return j["Type"].get<MsgType>();
-        return MsgType::Unknown;
-    }
-
-    Json Serialize() override
-    {
-        Json j;
-        j["Type"] = T;
-        return j;
-    }
+    static constexpr auto GetFields() { return std::tuple<>(); }
 };
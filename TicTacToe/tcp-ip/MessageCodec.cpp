@@ -0,0 +1,34 @@
+#include "MessageCodec.h"
+
+ReceivedMessage::ReceivedMessage(std::string_view data)
+{
+    if (data.empty())
+        throw std::runtime_error("Message is empty");
+
+    if (data.front() == '{')
+    {
+        m_Encoding = MessageEncoding::Json;
+        m_Fields = data;
+
+        // Only read up to the type, it is the first key when we wrote the message
+        JsonReader reader(data);
+        reader.BeginObject();
+        std::string_view key;
+        while (reader.NextKey(key))
+        {
+            if (key == "Type")
+            {
+                m_Type = reader.ReadEnum<MsgType>();
+                return;
+            }
+            reader.SkipValue();
+        }
+        // No type, the server reports it as unknown
+        return;
+    }
+
+    m_Encoding = MessageEncoding::Binary;
+    BinaryReader reader(data.data(), data.size());
+    m_Type = reader.ReadEnum<MsgType>();
+    m_Fields = data.substr(data.size() - reader.GetRemaining());
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include "ClientMessages.h"
+#include "ServerMessages.h"
+#include "Serializer.h"
+#include "TcpIp.h"
+#include <memory>
+#include <string_view>
+
+/// <summary>
+/// True for the messages of a running game. They are sent with FRAME_PRIORITY, a late move costs a player clock time.
+/// </summary>
+constexpr bool IsPriorityMessage(MsgType type)
+{
+    using enum MsgType;
+    return type == MakeMove || type == GameStarted || type == AcceptMakeMove || type == DeclineMakeMove
+        || type == GameOver || type == OpponentLeftLobby;
+}
+
+/// <summary>
+/// The frame header of a message, so the receiver can route, shed or prioritize it without reading the data.
+/// </summary>
+template <MsgType T>
+TcpIp::FrameInfo GetFrameInfo(MessageEncoding encoding)
+{
+    static_assert(static_cast<unsigned int>(T) <= UINT8_MAX, "The frame header holds the type in one byte");
+
+    uint8_t flags = encoding == MessageEncoding::Binary ? TcpIp::FRAME_BINARY : 0;
+    if constexpr (IsPriorityMessage(T))
+        flags |= TcpIp::FRAME_PRIORITY;
+    return { static_cast<uint8_t>(T), flags };
+}
+
+/// <summary>
+/// Appends a message to `output` in the given encoding. Nothing is allocated if `output` has the capacity.
+/// Both encodings start with the type: the first key of the JSON object, the first byte in binary.
+/// </summary>
+template <MsgType T>
+void EncodeMessage(const Message<T>& message, MessageEncoding encoding, std::string& output)
+{
+    if (encoding == MessageEncoding::Json)
+    {
+        JsonWriter writer(output);
+        writer.BeginObject();
+        writer.WriteKey("Type");
+        writer.WriteUInt(static_cast<uint64_t>(T));
+        Serializer::WriteFields(writer, message);
+        writer.EndObject();
+        return;
+    }
+
+    BinaryWriter writer(output);
+    writer.WriteEnum(T);
+    Serializer::Write(writer, message);
+}
+
+template <MsgType T>
+std::string EncodeMessage(const Message<T>& message, MessageEncoding encoding)
+{
+    std::string output;
+    EncodeMessage(message, encoding, output);
+    return output;
+}
+
+/// <summary>
+/// Encodes a whole frame: the header (see GetFrameInfo), then the message. The message is written in place, never copied.
+/// </summary>
+template <MsgType T>
+std::string EncodeFrame(const Message<T>& message, MessageEncoding encoding)
+{
+    std::string output(TcpIp::HEADER_SIZE, '\0');
+    EncodeMessage(message, encoding, output);
+    TcpIp::WriteHeader(output.data(), static_cast<u_long>(output.size() - TcpIp::HEADER_SIZE), GetFrameInfo<T>(encoding));
+    return output;
+}
+
+/// <summary>
+/// A message sent to several connections, encoded and framed at most once per encoding, when a connection first needs it.
+/// The frames are immutable and reference counted: every send shares them, none copies them.
+/// </summary>
+template <MsgType T>
+class BroadcastMessage final
+{
+public:
+    explicit BroadcastMessage(const Message<T>& message) : m_Message(message) {}
+
+    const std::shared_ptr<const std::string>& Get(MessageEncoding encoding)
+    {
+        std::shared_ptr<const std::string>& encoded = m_Encoded[static_cast<size_t>(encoding)];
+        if (!encoded)
+            encoded = std::make_shared<const std::string>(EncodeFrame(m_Message, encoding));
+        return encoded;
+    }
+
+private:
+    const Message<T>& m_Message;
+    std::shared_ptr<const std::string> m_Encoded[MESSAGE_ENCODING_COUNT];
+};
+
+/// <summary>
+/// The data of a received frame, whose type is read first. The fields are read with As once the type is known.
+/// JSON data starts with '{', binary data with its type, so both encodings can arrive on the same connection.
+/// JSON is read as a stream (see JsonReader): no document is built, the fields go straight into the message.
+/// </summary>
+class ReceivedMessage final
+{
+public:
+    /// <summary>
+    /// Reads the type of a message. Throws std::exception if the data is not a message.
+    /// `data` must outlive this object.
+    /// </summary>
+    explicit ReceivedMessage(std::string_view data);
+
+    MsgType GetType() const { return m_Type; }
+    MessageEncoding GetEncoding() const { return m_Encoding; }
+
+    /// <summary>
+    /// Reads the fields of the message. Throws std::exception if they don't match the type.
+    /// </summary>
+    template <MsgType T>
+    Message<T> As() const
+    {
+        Message<T> message;
+        if (m_Encoding == MessageEncoding::Json)
+        {
+            // The "Type" key is skipped like any unknown key
+            JsonReader reader(m_Fields);
+            Serializer::Read(reader, message);
+            reader.ExpectEnd();
+            return message;
+        }
+
+        BinaryReader reader(m_Fields.data(), m_Fields.size());
+        Serializer::Read(reader, message);
+        reader.ExpectEnd();
+        return message;
+    }
+
+private:
+    // The whole JSON object, or the binary data after the type
+    std::string_view m_Fields;
+    MsgType m_Type = MsgType::Unknown;
+    MessageEncoding m_Encoding = MessageEncoding::Json;
+};
@@ -0,0 +1,194 @@
+#pragma once
+#include "Fields.h"
+#include "BinaryStream.h"
+#include "JsonStream.h"
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Reads and writes the structs that list their fields (see Field), in binary and in JSON.
+/// Supported members: unsigned int, int, bool, enums, std::string, std::vector of any of them, and structs with fields.
+/// </summary>
+namespace Serializer
+{
+    template <typename T>
+    struct IsVector : std::false_type {};
+    template <typename T>
+    struct IsVector<std::vector<T>> : std::true_type {};
+
+    template <typename T>
+    void Write(BinaryWriter& writer, const T& value)
+    {
+        if constexpr (HasFields<T>)
+            std::apply([&](const auto&... fields) { (Write(writer, value.*fields.Member), ...); }, T::GetFields());
+        else if constexpr (IsVector<T>::value)
+        {
+            writer.WriteUInt(value.size());
+            for (const auto& element : value)
+            {
+                Write(writer, element);
+            }
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+            writer.WriteString(value);
+        else if constexpr (std::is_same_v<T, bool>)
+            writer.WriteBool(value);
+        else if constexpr (std::is_enum_v<T>)
+            writer.WriteEnum(value);
+        else if constexpr (std::is_same_v<T, int>)
+            writer.WriteInt(value);
+        else
+        {
+            static_assert(std::is_same_v<T, unsigned int>, "Unsupported field type");
+            writer.WriteUInt(value);
+        }
+    }
+
+    template <typename T>
+    void Read(BinaryReader& reader, T& value)
+    {
+        if constexpr (HasFields<T>)
+            std::apply([&](const auto&... fields) { (Read(reader, value.*fields.Member), ...); }, T::GetFields());
+        else if constexpr (IsVector<T>::value)
+        {
+            value.resize(reader.ReadCount());
+            for (auto& element : value)
+            {
+                Read(reader, element);
+            }
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+            value = reader.ReadString();
+        else if constexpr (std::is_same_v<T, bool>)
+            value = reader.ReadBool();
+        else if constexpr (std::is_enum_v<T>)
+            value = reader.ReadEnum<T>();
+        else if constexpr (std::is_same_v<T, int>)
+            value = reader.ReadInt32();
+        else
+        {
+            static_assert(std::is_same_v<T, unsigned int>, "Unsupported field type");
+            value = reader.ReadUInt32();
+        }
+    }
+
+    /// <summary>
+    /// Writes the fields of a struct as keys of the JSON object being written.
+    /// </summary>
+    template <HasFields T>
+    void WriteFields(JsonWriter& writer, const T& value);
+
+    template <typename T>
+    void Write(JsonWriter& writer, const T& value)
+    {
+        if constexpr (HasFields<T>)
+        {
+            writer.BeginObject();
+            WriteFields(writer, value);
+            writer.EndObject();
+        }
+        else if constexpr (IsVector<T>::value)
+        {
+            writer.BeginArray();
+            for (const auto& element : value)
+            {
+                Write(writer, element);
+            }
+            writer.EndArray();
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+            writer.WriteString(value);
+        else if constexpr (std::is_same_v<T, bool>)
+            writer.WriteBool(value);
+        else if constexpr (std::is_enum_v<T>)
+            writer.WriteUInt(static_cast<uint64_t>(value));
+        else if constexpr (std::is_same_v<T, int>)
+            writer.WriteInt(value);
+        else
+        {
+            static_assert(std::is_same_v<T, unsigned int>, "Unsupported field type");
+            writer.WriteUInt(value);
+        }
+    }
+
+    template <HasFields T>
+    void WriteFields(JsonWriter& writer, const T& value)
+    {
+        std::apply([&](const auto&... fields) { ((writer.WriteKey(fields.Name), Write(writer, value.*fields.Member)), ...); }, T::GetFields());
+    }
+
+    template <typename T>
+    void Read(JsonReader& reader, T& value);
+
+    /// <summary>
+    /// Reads the keys of the JSON object being read into the fields of a struct, in any order.
+    /// Unknown keys are skipped, a missing key that is not optional throws.
+    /// </summary>
+    template <HasFields T>
+    void ReadFields(JsonReader& reader, T& value)
+    {
+        constexpr auto fields = T::GetFields();
+        constexpr size_t fieldCount = std::tuple_size_v<decltype(fields)>;
+        static_assert(fieldCount <= 32, "Too many fields to track the missing ones");
+
+        uint32_t readFields = 0;
+        std::string_view key;
+        while (reader.NextKey(key))
+        {
+            const bool isKnown = [&]<size_t... I>(std::index_sequence<I...>)
+            {
+                return ((key == std::get<I>(fields).Name
+                    && (Read(reader, value.*std::get<I>(fields).Member), readFields |= 1u << I, true)) || ...);
+            }(std::make_index_sequence<fieldCount>());
+
+            if (!isKnown)
+                reader.SkipValue();
+        }
+
+        [&]<size_t... I>(std::index_sequence<I...>)
+        {
+            ([&](const auto& field)
+            {
+                if (!field.IsOptional && (readFields & (1u << I)) == 0)
+                    throw std::runtime_error(std::string("JSON object is missing \"") + field.Name + '"');
+            }(std::get<I>(fields)), ...);
+        }(std::make_index_sequence<fieldCount>());
+    }
+
+    /// <summary>
+    /// Reads a value from JSON text, straight into its members. Throws std::exception if the text does not match.
+    /// </summary>
+    template <typename T>
+    void Read(JsonReader& reader, T& value)
+    {
+        if constexpr (HasFields<T>)
+        {
+            reader.BeginObject();
+            ReadFields(reader, value);
+        }
+        else if constexpr (IsVector<T>::value)
+        {
+            value.clear();
+            reader.BeginArray();
+            while (reader.NextElement())
+            {
+                Read(reader, value.emplace_back());
+            }
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+            reader.ReadString(value);
+        else if constexpr (std::is_same_v<T, bool>)
+            value = reader.ReadBool();
+        else if constexpr (std::is_enum_v<T>)
+            value = reader.ReadEnum<T>();
+        else if constexpr (std::is_same_v<T, int>)
+            value = reader.ReadInt32();
+        else
+        {
+            static_assert(std::is_same_v<T, unsigned int>, "Unsupported field type");
+            value = reader.ReadUInt32();
+        }
+    }
+}
@@ -3,141 +3,95 @@
 #include "../game/Lobby.h"
 
 template <>
-struct Message<MsgType::LobbyList> : ISerializable
+struct Message<MsgType::LobbyList>
 {
-    Message() = default;
-    Message(const Json& j)
-        : LobbiesData()
-    {
-        LobbiesData.reserve(j["Lobbies"].size());
-
-        for (auto& lobby : j["Lobbies"])
-        {
-            LobbiesData.push_back(LobbyData(lobby));
-        }
-    }
-    ~Message() = default;
+    std::vector<LobbyData> LobbiesData;
+    // Version of the list, the base of the next RefreshLobbyList. (0 from older servers)
+    unsigned int Version = 0;
 
-    Json Serialize() override
+    static constexpr auto GetFields()
     {
-        Json j;
-        j["Type"] = MsgType::LobbyList;
-
-        for (auto& lobby : LobbiesData)
-        {
-            j["Lobbies"].push_back(lobby.Serialize());
-        }
-
-        return j;
+        return std::make_tuple(
+            MakeField("Lobbies", &Message::LobbiesData),
+            MakeOptionalField("Version", &Message::Version));
     }
-
-    std::vector<LobbyData> LobbiesData;
 };
 
+/// <summary>
+/// The lobbies that changed between two versions of the lobby list.
+/// A client whose list is not at BaseVersion missed a change, and has to fetch the list again.
+/// </summary>
 template <>
-struct Message<MsgType::GameHistoryList> : ISerializable
+struct Message<MsgType::RefreshLobbyList>
 {
-    Message() = default;
-    Message(const Json& j)
-    {
-        GameHistory.reserve(j["GameHistory"].size());
-
-        for (auto& game : j["GameHistory"])
-        {
-            GameHistory.push_back(GameData(game));
-        }
-    }
-    ~Message() = default;
+    unsigned int BaseVersion = 0;
+    unsigned int Version = 0;
+    std::vector<LobbyDelta> Changes;
 
-    Json Serialize() override
+    static constexpr auto GetFields()
     {
-        Json j;
-        j["Type"] = MsgType::GameHistoryList;
-
-        for (auto& game : GameHistory)
-        {
-            j["GameHistory"].push_back(game.Serialize());
-        }
-
-        return j;
+        return std::make_tuple(
+            MakeField("BaseVersion", &Message::BaseVersion),
+            MakeField("Version", &Message::Version),
+            MakeField("Changes", &Message::Changes));
     }
-
-    std::vector<GameData> GameHistory;
 };
 
 template <>
-struct Message<MsgType::GameStarted> : ISerializable
+struct Message<MsgType::GameHistoryList>
 {
-    Message() = default;
-    Message(const Json& j)
-        : StartPlayer(j["StartPlayer"]), GameMode(j["GameMode"]), PlayerX(j["PlayerX"]), PlayerO(j["PlayerO"])
-    {
-    }
-    ~Message() = default;
+    std::vector<GameData> GameHistory;
 
-    Json Serialize() override
+    static constexpr auto GetFields()
     {
-        Json j;
-        j["Type"] = MsgType::GameStarted;
-        j["GameMode"] = GameMode;
-        j["StartPlayer"] = StartPlayer;
-        j["PlayerX"] = PlayerX;
-        j["PlayerO"] = PlayerO;
-
-        return j;
+        return std::make_tuple(
+            MakeField("GameHistory", &Message::GameHistory));
     }
-
-    GameModeType GameMode;
-    std::string StartPlayer, PlayerX, PlayerO;
-
 };
 
 template <>
-struct Message<MsgType::AcceptMakeMove> : ISerializable
+struct Message<MsgType::GameStarted>
 {
-    Message() = default;
-    Message(const Json& j)
-        : Cell(j["Cell"].get<unsigned int>())
-        , Piece(j["Piece"].get<TicTacToe::Piece>())
-    {
-    }
-    ~Message() = default;
+    GameModeType GameMode;
+    std::string StartPlayer, PlayerX, PlayerO;
 
-    Json Serialize() override
+    static constexpr auto GetFields()
     {
-        Json j;
-        j["Type"] = MsgType::AcceptMakeMove;
-        j["Cell"] = Cell;
-        j["Piece"] = Piece;
-        return j;
+        return std::make_tuple(
+            MakeField("GameMode", &Message::GameMode),
+            MakeField("StartPlayer", &Message::StartPlayer),
+            MakeField("PlayerX", &Message::PlayerX),
+            MakeField("PlayerO", &Message::PlayerO));
     }
+};
 
+template <>
+struct Message<MsgType::AcceptMakeMove>
+{
     unsigned int LobbyId;
     unsigned int Cell;
     TicTacToe::Piece Piece;
+
+    static constexpr auto GetFields()
+    {
+        return std::make_tuple(
+            MakeField("Cell", &Message::Cell),
+            MakeField("Piece", &Message::Piece));
+    }
 };
 
 template <>
-struct Message<MsgType::GameOver> : ISerializable
+struct Message<MsgType::GameOver>
 {
-    Message() = default;
-    Message(const Json& j)
-        : Winner(j["Winner"]), Piece(j["Piece"]), IsDraw(j["IsDraw"].get<bool>())
-    {
-    }
-    ~Message() = default;
+    bool IsDraw = false;
+    std::string Winner;
+    TicTacToe::Piece Piece = TicTacToe::Piece::Empty;
 
-    Json Serialize() override
+    static constexpr auto GetFields()
     {
-        Json j;
-        j["Type"] = MsgType::GameOver;
-        j["Winner"] = Winner;
-        j["Piece"] = Piece;
-        j["IsDraw"] = IsDraw;
-        return j;
+        return std::make_tuple(
+            MakeField("Winner", &Message::Winner),
+            MakeField("Piece", &Message::Piece),
+            MakeField("IsDraw", &Message::IsDraw));
     }
-
-    bool IsDraw = false;
-    std::string Winner;
-    TicTacToe::Piece Piece;
 };
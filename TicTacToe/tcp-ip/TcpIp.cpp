@@ -1,4 +1,10 @@
 #include "TcpIp.h"
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/uio.h>
+#define sscanf_s sscanf
+#endif
 
 #if defined(DEBUG) | defined(_DEBUG)
 #include <crtdbg.h>
@@ -24,6 +30,7 @@ namespace TcpIp
         WSADATA WsaData;
 
     private:
+#ifdef _WIN32
         WsaInit()
         {
             int iResult = WSAStartup(MAKEWORD(2, 2), &WsaData);
@@ -37,6 +44,10 @@ namespace TcpIp
             if (iResult != 0)
                 throw TcpIpException::Create(WSA_CleanupFailed, iResult);
         }
+#else
+        // Nothing to initialize for BSD sockets.
+        WsaInit() : WsaData() {}
+#endif
     };
 
     WSADATA& InitializeWinsock()
@@ -46,113 +57,98 @@ namespace TcpIp
 
 #pragma region Header
 
-    constexpr const char* const HEADER_SIGNATURE = "T1cT4cT0z";
-    constexpr const int HEADER_SIGNATURE_SIZE = 9;
-    constexpr const int HEADER_SIZE = HEADER_SIGNATURE_SIZE + sizeof(u_long);
-
-    // Create a header to describe a data of the given size.
-    // /!\ The caller is responsible for the pointer created!
-    char* CreateHeader(const u_long size)
+    void WriteHeader(char* header, const u_long size, const FrameInfo info)
     {
-        char* header = new char[HEADER_SIZE];
         memcpy(header, HEADER_SIGNATURE, HEADER_SIGNATURE_SIZE);
+        header[HEADER_TYPE_OFFSET] = static_cast<char>(info.Type);
+        header[HEADER_FLAGS_OFFSET] = static_cast<char>(info.Flags);
 
-        u_long networkSize = htonl(size); // Convert to network byte order
-        memcpy(header + HEADER_SIGNATURE_SIZE, &networkSize, sizeof(u_long));
-        return header;
-    }
-
-    // Check if the given header has our signature.
-    inline bool IsHeaderValid(char* header)
-    {
-        return memcmp(header, HEADER_SIGNATURE, HEADER_SIGNATURE_SIZE) == 0;
-    }
-
-    // Get the size of the next data in the given header.
-    inline u_long GetSizeFromHeader(char* header)
-    {
-        u_long networkSize;
-        memcpy(&networkSize, header + HEADER_SIGNATURE_SIZE, sizeof(u_long));
-        return ntohl(networkSize); // Convert to host byte order
+        uint32_t networkSize = htonl(static_cast<uint32_t>(size)); // Convert to network byte order
+        memcpy(header + HEADER_DATA_SIZE_OFFSET, &networkSize, sizeof(uint32_t));
     }
 
 #pragma endregion
 
-    void Send(const SOCKET& socket, const char* data, const u_long size)
+    // Wait until the socket can accept more data.
+    static void WaitWritable(const SOCKET& socket)
     {
-        char* buffer = new char[HEADER_SIZE + size];
-
-        // Create header and copy it to buffer
-        char* header = CreateHeader(size);
-        memcpy(buffer, header, HEADER_SIZE);
-        delete[] header;
-
-        // Copy data to buffer and send it
-        memcpy(buffer + HEADER_SIZE, data, size);
-        int iResult = send(socket, buffer, HEADER_SIZE + static_cast<int>(size), 0);
-        delete[] buffer;
-
-        if (iResult == SOCKET_ERROR)
+        fd_set writeSet;
+        FD_ZERO(&writeSet);
+        FD_SET(socket, &writeSet);
+        if (select(static_cast<int>(socket) + 1, nullptr, &writeSet, nullptr, nullptr) == SOCKET_ERROR)
             throw TcpIpException::Create(SEND_DataFailed, TCP_IP_WSA_ERROR);
     }
 
-    void Receive(const SOCKET& socket, std::stringstream& ss, const unsigned int bufferSize)
+    void Send(const SOCKET& socket, const char* data, const u_long size, const FrameInfo info)
     {
-        // Receive header
+        // The header lives on the stack, the data stays in the caller's buffer
         char header[HEADER_SIZE];
-        int iResult = recv(socket, header, HEADER_SIZE, 0);
+        WriteHeader(header, size, info);
 
-        // iResult is number of bytes received
-        if (iResult == SOCKET_ERROR)
+        SendBuffer buffers[2] = {{header, HEADER_SIZE}, {data, size}};
+        size_t count = 2;
+        while (count > 0)
         {
-            throw TcpIpException::Create(RECEIVE_HeaderFailed, TCP_IP_WSA_ERROR);
+            size_t sent = TrySend(socket, buffers + 2 - count, count);
+            if (sent == 0)
+            {
+                WaitWritable(socket);
+                continue;
+            }
+
+            // The system may send less than asked, in that case send what's left
+            while (count > 0 && sent >= buffers[2 - count].Size)
+            {
+                sent -= buffers[2 - count].Size;
+                --count;
+            }
+            if (count > 0)
+            {
+                buffers[2 - count].Data += sent;
+                buffers[2 - count].Size -= sent;
+            }
         }
+    }
+
+    size_t TrySend(const SOCKET& socket, const SendBuffer* buffers, size_t count)
+    {
+        if (count > MAX_SEND_BUFFERS)
+            count = MAX_SEND_BUFFERS;
 
-        if (iResult != HEADER_SIZE) // Received less than expected
+#ifdef _WIN32
+        WSABUF wsaBuffers[MAX_SEND_BUFFERS];
+        for (size_t i = 0; i < count; ++i)
         {
-            throw TcpIpException::Create(RECEIVE_HeaderHadInvalidSize, HEADER_SIZE - iResult);
+            wsaBuffers[i] = {static_cast<ULONG>(buffers[i].Size), const_cast<char*>(buffers[i].Data)};
         }
 
-        // Check header
-        if (!IsHeaderValid(header))
+        DWORD sent = 0;
+        if (WSASend(socket, wsaBuffers, static_cast<DWORD>(count), &sent, 0, nullptr, nullptr) == SOCKET_ERROR)
         {
-            throw TcpIpException::Create(RECEIVE_HeaderHadInvalidSignature);
+            if (IsWouldBlockError(WSAGetLastError()))
+                return 0;
+            throw TcpIpException::Create(SEND_DataFailed, TCP_IP_WSA_ERROR);
         }
-
-        // Get the the data size
-        u_long dataSize = GetSizeFromHeader(header);
-
-        // Get the data
-        char* buffer = new char[bufferSize];
-        while (dataSize > 0)
+#else
+        iovec ioBuffers[MAX_SEND_BUFFERS];
+        for (size_t i = 0; i < count; ++i)
         {
-            // recvSize = min(dataSize, bufferSize), because there might be more data to receive 
-            int recvSize = dataSize > bufferSize ? bufferSize : static_cast<int>(dataSize);
-            iResult = recv(socket, buffer, recvSize, 0);
-
-            // iResult is number of bytes received
-            if (iResult == SOCKET_ERROR)
-            {
-                delete[] buffer;
-                throw TcpIpException::Create(RECEIVE_DataFailed, TCP_IP_WSA_ERROR);
-            }
-
-            if (iResult != recvSize)
-            {
-                delete[] buffer;
-                throw TcpIpException::Create(RECEIVE_DataHadInvalidSize, recvSize - iResult);
-            }
-
-            // Write buffer to stream
-            ss.write(buffer, iResult);
-            dataSize -= iResult;
+            ioBuffers[i] = {const_cast<char*>(buffers[i].Data), buffers[i].Size};
         }
-        delete[] buffer;
 
-        if (dataSize != 0)
+        // sendmsg instead of writev, to be able to pass the send flags
+        msghdr message = {};
+        message.msg_iov = ioBuffers;
+        message.msg_iovlen = count;
+        ssize_t sent = sendmsg(socket, &message, TCP_IP_SEND_FLAGS);
+        if (sent == SOCKET_ERROR)
         {
-            throw TcpIpException::Create(RECEIVE_DataHadInvalidSize, dataSize);
+            if (IsWouldBlockError(WSAGetLastError()))
+                return 0;
+            throw TcpIpException::Create(SEND_DataFailed, TCP_IP_WSA_ERROR);
         }
+#endif
+        return static_cast<size_t>(sent);
     }
 
     void CloseSocket(SOCKET& socket)
@@ -184,9 +180,40 @@ namespace TcpIp
 
     void SendHtmlResponse(const SOCKET& socket, const char* data, u_long size)
     {
-        send(socket, data, static_cast<int>(size), 0);
+        send(socket, data, static_cast<int>(size), TCP_IP_SEND_FLAGS);
+    }
+
+    bool IsWouldBlockError(int error)
+    {
+#ifdef _WIN32
+        return error == WSAEWOULDBLOCK;
+#else
+        return error == EWOULDBLOCK || error == EAGAIN;
+#endif
+    }
+
+    bool IsTransientAcceptError(int error)
+    {
+#ifdef _WIN32
+        return error == WSAECONNRESET || error == WSAEINTR;
+#else
+        // Linux also reports the pending network errors of the new socket through accept()
+        return error == ECONNABORTED || error == EINTR || error == EPROTO || error == EPERM
+            || error == ENETDOWN || error == ENETUNREACH || error == EHOSTUNREACH || error == EHOSTDOWN
+            || error == ENOPROTOOPT || error == EOPNOTSUPP;
+#endif
+    }
+
+    bool IsOutOfResourcesError(int error)
+    {
+#ifdef _WIN32
+        return error == WSAEMFILE || error == WSAENOBUFS;
+#else
+        return error == EMFILE || error == ENFILE || error == ENOBUFS || error == ENOMEM;
+#endif
     }
 
+#ifdef _WIN32
     WSAEVENT CreateEventObject(const SOCKET& socket, const long networkEvents)
     {
         WSAEVENT eventObj = WSACreateEvent();
@@ -210,6 +237,7 @@ namespace TcpIp
             throw TcpIpException::Create(ErrorCode::EVENT_CloseFailed, TCP_IP_WSA_ERROR);
         event = WSA_INVALID_EVENT;
     }
+#endif // _WIN32
 
     IpAddress IpAddress::GetLocalAddress()
     {
@@ -1,8 +1,39 @@
 #pragma once
 
+#ifdef _WIN32
 #pragma comment(lib, "Ws2_32.lib")
 #include <winsock2.h>
 #include <ws2tcpip.h>
+
+// Flags passed to every send() call.
+constexpr int TCP_IP_SEND_FLAGS = 0;
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <cerrno>
+
+// Minimal Winsock vocabulary for POSIX systems, so the shared code can stay the same on both platforms.
+typedef int SOCKET;
+typedef addrinfo ADDRINFO;
+struct WSADATA {};
+constexpr SOCKET INVALID_SOCKET = -1;
+constexpr int SOCKET_ERROR = -1;
+constexpr int SD_SEND = SHUT_WR;
+constexpr int WSAEWOULDBLOCK = EWOULDBLOCK;
+inline int closesocket(SOCKET socket) { return close(socket); }
+inline int WSAGetLastError() { return errno; }
+
+// Flags passed to every send() call. (Do not raise SIGPIPE when the peer is gone, report an error instead)
+constexpr int TCP_IP_SEND_FLAGS = MSG_NOSIGNAL;
+#endif
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
 #include <sstream>
 
 constexpr unsigned int DEFAULT_PORT = 63064;
@@ -14,19 +45,83 @@ constexpr int TCP_IP_WSA_ERROR = 0;
 /// </summary>
 namespace TcpIp
 {
+    // Every message is sent as a frame: [signature][type (1 byte)][flags (1 byte)][data size (4 bytes, network order)][data]
+    constexpr const char* const HEADER_SIGNATURE = "T1cT4cT0z";
+    constexpr const int HEADER_SIGNATURE_SIZE = 9;
+    constexpr const int HEADER_TYPE_OFFSET = HEADER_SIGNATURE_SIZE;
+    constexpr const int HEADER_FLAGS_OFFSET = HEADER_TYPE_OFFSET + 1;
+    constexpr const int HEADER_DATA_SIZE_OFFSET = HEADER_FLAGS_OFFSET + 1;
+    // The size is always sent as 4 bytes, whatever the size of u_long is on this platform.
+    constexpr const int HEADER_SIZE = HEADER_DATA_SIZE_OFFSET + sizeof(uint32_t);
+    // Frames announcing more data than this are rejected, the stream is considered corrupted.
+    constexpr const uint32_t MAX_FRAME_DATA_SIZE = 1 << 20;
+    // Bytes read from one socket per readiness event, so a busy peer cannot hold the thread. The rest is read on the next event.
+    constexpr const size_t MAX_RECEIVE_SIZE = 64 * 1024;
+
+    /// <summary>
+    /// Flags of a frame, so the receiver can decide what to do with it before reading its data.
+    /// </summary>
+    enum FrameFlag : uint8_t
+    {
+        // The data is in the binary message encoding, JSON otherwise
+        FRAME_BINARY = 1 << 0,
+        // The data is compressed. Reserved, nothing compresses yet: receivers drop these frames
+        FRAME_COMPRESSED = 1 << 1,
+        // The data belongs to a running game, it is handled even when the receiver sheds load
+        FRAME_PRIORITY = 1 << 2,
+    };
+
+    /// <summary>
+    /// What the header of a frame tells about its data.
+    /// </summary>
+    struct FrameInfo
+    {
+        // The MsgType of the message, 0 if the sender did not tell
+        uint8_t Type = 0;
+        uint8_t Flags = 0;
+
+        bool HasFlag(FrameFlag flag) const { return (Flags & flag) != 0; }
+    };
+
+    /// <summary>
+    /// A frame extracted from a stream.
+    /// </summary>
+    struct Frame
+    {
+        FrameInfo Info;
+        std::string Data;
+    };
+
     /// <summary>
     /// Initializes Winsock and returns WSADATA.
     /// </summary>
     WSADATA& InitializeWinsock();
 
     /// <summary>
-    /// Sends data to a socket.
+    /// Writes the header describing data of the given size. (`header` must hold HEADER_SIZE bytes)
     /// </summary>
-    void Send(const SOCKET& socket, const char* data, u_long size);
+    void WriteHeader(char* header, u_long size, FrameInfo info);
     /// <summary>
-    /// Receives data from a socket. (Blocking, until peer shuts down the connection)
+    /// Sends data to a socket, waiting for the socket to be writable if needed.
+    /// The header and the data are given to the system in one vectored call, the data is never copied.
     /// </summary>
-    void Receive(const SOCKET& socket, std::stringstream& ss, const unsigned int bufferSize);
+    void Send(const SOCKET& socket, const char* data, u_long size, FrameInfo info = {});
+
+    /// <summary>
+    /// A piece of memory to send with TrySend.
+    /// </summary>
+    struct SendBuffer
+    {
+        const char* Data;
+        size_t Size;
+    };
+    // Maximum number of buffers given to one TrySend call.
+    constexpr const size_t MAX_SEND_BUFFERS = 32;
+    /// <summary>
+    /// Sends as much of the buffers as the socket accepts right now, in order, with one system call.
+    /// </summary>
+    /// <returns>The number of bytes sent. 0 if the socket would block.</returns>
+    size_t TrySend(const SOCKET& socket, const SendBuffer* buffers, size_t count);
     /// <summary>
     /// Closes a socket and sets it to INVALID_SOCKET.
     /// </summary>
@@ -41,6 +136,20 @@ namespace TcpIp
     /// </summary>
     void SendHtmlResponse(const SOCKET& socket, const char* data, u_long size);
 
+    /// <summary>
+    /// Returns true if the last socket error means "try again later" on a non-blocking socket.
+    /// </summary>
+    bool IsWouldBlockError(int error);
+    /// <summary>
+    /// Returns true if accept() failed for this one connection only (it was reset before being accepted), the next ones can still be accepted.
+    /// </summary>
+    bool IsTransientAcceptError(int error);
+    /// <summary>
+    /// Returns true if the last socket error means the process or the system is out of sockets or memory.
+    /// </summary>
+    bool IsOutOfResourcesError(int error);
+
+#ifdef _WIN32
     /// <summary>
     /// Creates an event that listen to the specified network events on the specified socket.
     /// </summary>
@@ -49,6 +158,7 @@ namespace TcpIp
     /// Closes an event object and sets it to WSA_INVALID_EVENT.
     /// </summary>
     void CloseEventObject(WSAEVENT& event);
+#endif // _WIN32
 
     /// <summary>
     /// Error codes for TCP/IP.
@@ -72,6 +182,7 @@ namespace TcpIp
         EVENT_FdAcceptHadError,
         EVENT_FdReadHadError,
         EVENT_FdCloseHadError,
+        EVENT_FdWriteHadError,
         EVENT_CloseFailed,
         SEND_HeaderFailed,
         SEND_DataFailed,
@@ -80,6 +191,7 @@ namespace TcpIp
         RECEIVE_HeaderHadInvalidSignature,
         RECEIVE_DataFailed,
         RECEIVE_DataHadInvalidSize,
+        RECEIVE_FrameTooLarge,
 
 #ifdef WINDOW_EVENT
         WINDOW_CreateFailed,
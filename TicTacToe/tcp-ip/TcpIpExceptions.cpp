@@ -1,4 +1,5 @@
 #include "TcpIp.h"
+#include <cstring>
 
 namespace TcpIp
 {
@@ -23,14 +24,16 @@ namespace TcpIp
             "FD_ACCEPT had error.",
             "FD_READ had error.",
             "FD_CLOSE had error.",
+            "FD_WRITE had error.",
             "WSACloseEvent failed.",
             "Header send failed.",
             "Data send failed.",
             "Header recv failed.",
             "Header recv had invalid size.",
-            "Header recv had invalid signature."
+            "Header recv had invalid signature.",
             "Data recv failed.",
             "Data recv had invalid size.",
+            "Frame recv was too large.",
         };
 
         if (static_cast<unsigned int>(code) >= sizeof(names) / sizeof(names[0]))
@@ -40,6 +43,10 @@ namespace TcpIp
 
     const char* GetWsaErrorExplanation(int errorCode)
     {
+#ifndef _WIN32
+        // BSD sockets report errno values
+        return strerror(errorCode);
+#else
         switch (errorCode)
         {
         case WSA_INVALID_HANDLE: return ("Specified event object handle is invalid.");
@@ -139,6 +146,7 @@ namespace TcpIp
         case WSA_QOS_RESERVED_PETYPE: return ("Reserved policy QoS element type.");
         default: return ("Unknown error.");
         }
+#endif // _WIN32
     }
 
     std::string GetErrorMessage(ErrorCode code, int context)
@@ -164,6 +172,7 @@ namespace TcpIp
         case EVENT_FdAcceptHadError:
         case EVENT_FdReadHadError:
         case EVENT_FdCloseHadError:
+        case EVENT_FdWriteHadError:
         case EVENT_CloseFailed:
         case SEND_HeaderFailed:
         case SEND_DataFailed:
@@ -182,6 +191,9 @@ namespace TcpIp
         case RECEIVE_DataHadInvalidSize:
             oss << GetErrorCodeName(code) << "\nReason: Data had invalid size. Difference (expected - actual): " << context;
             break;
+        case RECEIVE_FrameTooLarge:
+            oss << GetErrorCodeName(code) << "\nReason: Header announced more data than allowed. Announced size: " << context;
+            break;
         default:
             oss << GetErrorCodeName(code);
             break;